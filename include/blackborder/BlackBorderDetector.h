@@ -1,7 +1,11 @@
 #pragma once
 
+// STL includes
+#include <vector>
+
 // Utils includes
 #include <utils/Image.h>
+#include <utils/ColorRgb.h>
 
 namespace hyperion
 {
@@ -37,10 +41,236 @@ namespace hyperion
 		}
 	};
 
+	///
+	/// Maximum channel values of the rows and columns of an image, reduced in one streaming pass over the image.
+	/// A line is black, if its maximum channel is below the black-border threshold.
+	/// Rows are reduced per row segment (twelfths of the width) and columns per column segment (thirds of the height),
+	/// so the detection modes can restrict a line to the part they trust, e.g. to ignore subtitles.
+	///
+	class BlackBorderLineSummaries
+	{
+	public:
+		/// Number of segments a row is split into (twelfths, so thirds and quarters of the width are whole segments)
+		static constexpr int ROW_SEGMENTS = 12;
+		/// Number of segments a column is split into (thirds of the height)
+		static constexpr int COLUMN_SEGMENTS = 3;
+
+		BlackBorderLineSummaries();
+
+		///
+		/// Reduces the rows and columns of the given image, using SSE2/NEON where available
+		///
+		/// @param[in] image  The image
+		///
+		void scan(const Image<ColorRgb> & image);
+
+		///
+		/// Reduces the rows and columns of the given image pixel by pixel
+		///
+		/// @param[in] image  The image
+		///
+		template <typename Pixel_T>
+		void scan(const Image<Pixel_T> & image)
+		{
+			resize(image.width(), image.height());
+
+			for (int y = 0; y < _height; ++y)
+			{
+				uint8_t* rowMax = &_rows[static_cast<size_t>(y) * ROW_SEGMENTS];
+				uint8_t* columnMax = &_columns[static_cast<size_t>(columnSegment(y)) * _width];
+				for (int segment = 0; segment < ROW_SEGMENTS; ++segment)
+				{
+					for (int x = segmentBegin(_width, ROW_SEGMENTS, segment); x < segmentBegin(_width, ROW_SEGMENTS, segment + 1); ++x)
+					{
+						const Pixel_T & color = image(x, y);
+						const uint8_t channelMax = qMax(color.red, qMax(color.green, color.blue));
+						rowMax[segment] = qMax(rowMax[segment], channelMax);
+						columnMax[x] = qMax(columnMax[x], channelMax);
+					}
+				}
+			}
+		}
+
+		///
+		/// Returns the maximum channel of a row within the given row segments
+		///
+		/// @param[in] y             The row
+		/// @param[in] firstSegment  The first segment
+		/// @param[in] endSegment    The segment after the last one
+		///
+		uint8_t rowMax(int y, int firstSegment, int endSegment) const
+		{
+			const uint8_t* rowMax = &_rows[static_cast<size_t>(y) * ROW_SEGMENTS];
+			uint8_t result = 0;
+			for (int segment = firstSegment; segment < endSegment; ++segment)
+			{
+				result = qMax(result, rowMax[segment]);
+			}
+			return result;
+		}
+
+		///
+		/// Returns the maximum channel of a column within the given column segments
+		///
+		/// @param[in] x             The column
+		/// @param[in] firstSegment  The first segment
+		/// @param[in] endSegment    The segment after the last one
+		///
+		uint8_t columnMax(int x, int firstSegment, int endSegment) const
+		{
+			uint8_t result = 0;
+			for (int segment = firstSegment; segment < endSegment; ++segment)
+			{
+				result = qMax(result, _columns[static_cast<size_t>(segment) * _width + x]);
+			}
+			return result;
+		}
+
+	private:
+		/// Returns the first index of a segment, segments of the same length +-1 covering all of the length
+		static int segmentBegin(int length, int segments, int segment)
+		{
+			return length * segment / segments;
+		}
+
+		/// Returns the column segment of a row
+		int columnSegment(int y) const
+		{
+			return y * COLUMN_SEGMENTS / _height;
+		}
+
+		/// Sets the image size and clears the summaries
+		void resize(int width, int height);
+
+		int _width;
+		int _height;
+
+		/// Maximum channel per row and row segment
+		std::vector<uint8_t> _rows;
+		/// Maximum channel per column segment and column
+		std::vector<uint8_t> _columns;
+		/// Maximum byte per column segment and column byte, the channels are reduced after the scan
+		std::vector<uint8_t> _columnBytes;
+	};
+
+	///
+	/// A small luminance proxy of an image for black-border detection on large images.
+	/// Every proxy pixel holds the maximum channel of a few pixels sampled in its block of the image (as gray color),
+	/// i.e. a proxy pixel is black if all sampled pixels are. The samples always include the last row and column of a
+	/// block, so a block holding the start of the picture behind a top or left border is never black on the proxy.
+	/// Borders detected on the proxy are mapped back to the start of the first block after them, i.e. they are rounded
+	/// down by less than a block and do not cut off the picture, unless it is darker than the threshold at its edge.
+	///
+	class BlackBorderProxy
+	{
+	public:
+		/// Width of the proxy image
+		static constexpr int WIDTH = 64;
+		/// Height of the proxy image
+		static constexpr int HEIGHT = 36;
+		/// Number of pixels sampled per block in each direction, spread evenly up to the last row/column of the block
+		static constexpr int SAMPLES = 4;
+
+		BlackBorderProxy()
+			: _image(WIDTH, HEIGHT)
+			, _imageWidth(0)
+			, _imageHeight(0)
+		{
+		}
+
+		///
+		/// Returns true, if detection on the proxy is cheaper than on the given image
+		///
+		template <typename Pixel_T>
+		static bool isReducing(const Image<Pixel_T> & image)
+		{
+			return image.width() >= 2 * WIDTH && image.height() >= 2 * HEIGHT;
+		}
+
+		///
+		/// Samples the proxy of the given image
+		///
+		/// @param[in] image  The image, at least as large as the proxy
+		///
+		template <typename Pixel_T>
+		void create(const Image<Pixel_T> & image)
+		{
+			_imageWidth = image.width();
+			_imageHeight = image.height();
+
+			for (int yBlock = 0; yBlock < HEIGHT; ++yBlock)
+			{
+				const int yBegin = blockBegin(_imageHeight, HEIGHT, yBlock);
+				const int blockHeight = blockBegin(_imageHeight, HEIGHT, yBlock + 1) - yBegin;
+				for (int xBlock = 0; xBlock < WIDTH; ++xBlock)
+				{
+					const int xBegin = blockBegin(_imageWidth, WIDTH, xBlock);
+					const int blockWidth = blockBegin(_imageWidth, WIDTH, xBlock + 1) - xBegin;
+
+					uint8_t luminance = 0;
+					for (int ySample = 0; ySample < SAMPLES; ++ySample)
+					{
+						const int y = yBegin + samplePosition(blockHeight, ySample);
+						for (int xSample = 0; xSample < SAMPLES; ++xSample)
+						{
+							const Pixel_T & color = image(xBegin + samplePosition(blockWidth, xSample), y);
+							luminance = qMax(luminance, qMax(color.red, qMax(color.green, color.blue)));
+						}
+					}
+					_image(xBlock, yBlock) = ColorRgb(luminance, luminance, luminance);
+				}
+			}
+		}
+
+		///
+		/// Returns the proxy image
+		///
+		const Image<ColorRgb> & image() const
+		{
+			return _image;
+		}
+
+		///
+		/// Maps a border detected on the proxy image to the image the proxy was created of
+		///
+		/// @param[in] border  The border detected on the proxy image
+		///
+		/// @return The border in image coordinates
+		///
+		BlackBorder toImageBorder(const BlackBorder & border) const
+		{
+			BlackBorder imageBorder = border;
+			if (!border.unknown)
+			{
+				imageBorder.horizontalSize = blockBegin(_imageHeight, HEIGHT, qMax(border.horizontalSize, 0));
+				imageBorder.verticalSize = blockBegin(_imageWidth, WIDTH, qMax(border.verticalSize, 0));
+			}
+			return imageBorder;
+		}
+
+	private:
+		/// Returns the first index of an image block
+		static int blockBegin(int length, int blocks, int block)
+		{
+			return length * block / blocks;
+		}
+
+		/// Returns the offset of a sample in its block, the last sample is the last index of the block
+		static int samplePosition(int blockLength, int sample)
+		{
+			return blockLength - 1 - (SAMPLES - 1 - sample) * blockLength / SAMPLES;
+		}
+
+		Image<ColorRgb> _image;
+
+		int _imageWidth;
+		int _imageHeight;
+	};
+
 	///
 	/// The BlackBorderDetector performs detection of black-borders on a single image.
-	/// The detector will search for the upper left corner of the picture in the frame.
-	/// Based on detected black pixels it will give an estimate of the black-border.
+	/// The detector reduces the rows and columns of the image to their maximum channels first
+	/// and estimates the black-border from the black rows and columns at the sides of the picture.
 	///
 	class BlackBorderDetector
 	{
@@ -62,35 +292,26 @@ namespace hyperion
 		uint8_t calculateThreshold(double blackborderThreshold) const;
 
 		///
-		/// default detection mode (3lines 4side detection)
+		/// default detection mode (4side detection)
 		template <typename Pixel_T>
 		BlackBorder process(const Image<Pixel_T> & image) const
 		{
-			// test centre and 33%, 66% of width/height
-			// 33 and 66 will check left and top
-			// centre will check right and bottom sides
-			int width = image.width();
-			int height = image.height();
-			int width33percent = width / 3;
-			int height33percent = height / 3;
-			int width66percent = width33percent * 2;
-			int height66percent = height33percent * 2;
-			int xCenter = width / 2;
-			int yCenter = height / 2;
+			// the middle third of the rows checks the left and right side,
+			// the middle third of the columns checks the top and bottom side
+			_summaries.scan(image);
 
+			const int width = image.width();
+			const int height = image.height();
+			const int width33percent = width / 3;
+			const int height33percent = height / 3;
 
 			int firstNonBlackXPixelIndex = -1;
 			int firstNonBlackYPixelIndex = -1;
 
-			width--; // remove 1 pixel to get end pixel index
-			height--;
-
 			// find first X pixel of the image
 			for (int x = 0; x < width33percent; ++x)
 			{
-				if (!isBlack(image((width - x), yCenter))
-					|| !isBlack(image(x, height33percent))
-				 	|| !isBlack(image(x, height66percent)))
+				if (!isBlackColumn(x, 1, 2) || !isBlackColumn(width - 1 - x, 1, 2))
 				{
 					firstNonBlackXPixelIndex = x;
 					break;
@@ -100,9 +321,7 @@ namespace hyperion
 			// find first Y pixel of the image
 			for (int y = 0; y < height33percent; ++y)
 			{
-				if (!isBlack(image(xCenter, (height - y)))
-					|| !isBlack(image(width33percent, y))
-					|| !isBlack(image(width66percent, y)))
+				if (!isBlackRow(y, 4, 8) || !isBlackRow(height - 1 - y, 4, 8))
 				{
 					firstNonBlackYPixelIndex = y;
 					break;
@@ -119,49 +338,35 @@ namespace hyperion
 
 
 		///
-		/// classic detection mode (topleft single line mode)
+		/// classic detection mode (topleft detection)
 		template <typename Pixel_T>
 		BlackBorder process_classic(const Image<Pixel_T> & image) const
 		{
 			// only test the topleft third of the image
-			int width = image.width() /3;
-			int height = image.height() / 3;
-			int maxSize = qMax(width, height);
+			_summaries.scan(image);
+
+			const int width = image.width() / 3;
+			const int height = image.height() / 3;
 
 			int firstNonBlackXPixelIndex = -1;
 			int firstNonBlackYPixelIndex = -1;
 
-			// find some pixel of the image
-			for (int i = 0; i < maxSize; ++i)
+			// find the first column with a pixel in the top third
+			for (int x = 0; x <= width; ++x)
 			{
-				int x = qMin(i, width);
-				int y = qMin(i, height);
-
-				const Pixel_T & color = image(x, y);
-				if (!isBlack(color))
+				if (!isBlackColumn(x, 0, 1))
 				{
 					firstNonBlackXPixelIndex = x;
-					firstNonBlackYPixelIndex = y;
-					break;
-				}
-			}
-
-			// expand image to the left
-			for(; firstNonBlackXPixelIndex > 0; --firstNonBlackXPixelIndex)
-			{
-				const Pixel_T & color = image(firstNonBlackXPixelIndex-1, firstNonBlackYPixelIndex);
-				if (isBlack(color))
-				{
 					break;
 				}
 			}
 
-			// expand image to the top
-			for(; firstNonBlackYPixelIndex > 0; --firstNonBlackYPixelIndex)
+			// find the first row with a pixel in the left third
+			for (int y = 0; y <= height; ++y)
 			{
-				const Pixel_T & color = image(firstNonBlackXPixelIndex, firstNonBlackYPixelIndex-1);
-				if (isBlack(color))
+				if (!isBlackRow(y, 0, 4))
 				{
+					firstNonBlackYPixelIndex = y;
 					break;
 				}
 			}
@@ -176,33 +381,26 @@ namespace hyperion
 
 
 		///
-		/// osd detection mode (find x then y at detected x to avoid changes by osd overlays)
+		/// osd detection mode (find y at the left and right third only to avoid changes by osd overlays)
 		template <typename Pixel_T>
 		BlackBorder process_osd(const Image<Pixel_T> & image) const
 		{
-			// find X position at height33 and height66 we check from the left side, Ycenter will check from right side
-			// then we try to find a pixel at this X position from top and bottom and right side from top
-			int width = image.width();
-			int height = image.height();
-			int width33percent = width / 3;
-			int height33percent = height / 3;
-			int height66percent = height33percent * 2;
-			int yCenter = height / 2;
+			// the middle third of the rows checks the left and right side,
+			// the left and right third of the columns check the top and bottom side, as osd overlays are mostly centred
+			_summaries.scan(image);
 
+			const int width = image.width();
+			const int height = image.height();
+			const int width33percent = width / 3;
+			const int height33percent = height / 3;
 
 			int firstNonBlackXPixelIndex = -1;
 			int firstNonBlackYPixelIndex = -1;
 
-			width--; // remove 1 pixel to get end pixel index
-			height--;
-
 			// find first X pixel of the image
-			int x;
-			for (x = 0; x < width33percent; ++x)
+			for (int x = 0; x < width33percent; ++x)
 			{
-				if (!isBlack(image((width - x), yCenter))
-					|| !isBlack(image(x, height33percent))
-					|| !isBlack(image(x, height66percent)))
+				if (!isBlackColumn(x, 1, 2) || !isBlackColumn(width - 1 - x, 1, 2))
 				{
 					firstNonBlackXPixelIndex = x;
 					break;
@@ -212,11 +410,9 @@ namespace hyperion
 			// find first Y pixel of the image
 			for (int y = 0; y < height33percent; ++y)
 			{
-				// left side top + left side bottom + right side top  +  right side bottom
-				if (!isBlack(image(x, y))
-					|| !isBlack(image(x, (height - y)))
-					|| !isBlack(image((width - x), y))
-					|| !isBlack(image((width - x), (height - y))))
+				// left side top + right side top + left side bottom + right side bottom
+				if (!isBlackRow(y, 0, 4) || !isBlackRow(y, 8, 12)
+					|| !isBlackRow(height - 1 - y, 0, 4) || !isBlackRow(height - 1 - y, 8, 12))
 				{
 					firstNonBlackYPixelIndex = y;
 					break;
@@ -233,33 +429,25 @@ namespace hyperion
 
 
 		///
-		/// letterbox detection mode (5lines top-bottom only detection)
+		/// letterbox detection mode (top-bottom only detection)
 		template <typename Pixel_T>
 		BlackBorder process_letterbox(const Image<Pixel_T> & image) const
 		{
-			// test center and 25%, 75% of width
-			// 25 and 75 will check both top and bottom
-			// center will only check top (minimise false detection of captions)
-			int width = image.width();
-			int height = image.height();
-			int width25percent = width / 4;
-			int height33percent = height / 3;
-			int width75percent = width25percent * 3;
-			int xCenter = width / 2;
+			// the middle half of the columns checks the top,
+			// the outer quarters check the bottom (minimise false detection of captions)
+			_summaries.scan(image);
 
+			const int height = image.height();
+			const int height33percent = height / 3;
 
 			int firstNonBlackYPixelIndex = -1;
 
-			height--; // remove 1 pixel to get end pixel index
-
 			// find first Y pixel of the image
 			for (int y = 0; y < height33percent; ++y)
 			{
-				if (!isBlack(image(xCenter, y))
-					|| !isBlack(image(width25percent, y))
-					|| !isBlack(image(width75percent, y))
-					|| !isBlack(image(width25percent, (height - y)))
-					|| !isBlack(image(width75percent, (height - y))))
+				if (!isBlackRow(y, 3, 9)
+					|| !isBlackRow(height - 1 - y, 0, 3)
+					|| !isBlackRow(height - 1 - y, 9, 12))
 				{
 					firstNonBlackYPixelIndex = y;
 					break;
@@ -279,22 +467,38 @@ namespace hyperion
 	private:
 
 		///
-		/// Checks if a given color is considered black and therefore could be part of the border.
+		/// Checks if a row of the last scanned image is considered black within the given row segments
 		///
-		/// @param[in] color  The color to check
+		/// @param[in] y             The row
+		/// @param[in] firstSegment  The first row segment (twelfths of the width)
+		/// @param[in] endSegment    The segment after the last one
 		///
-		/// @return True if the color is considered black else false
+		/// @return True if all pixels are considered black else false
 		///
-		template <typename Pixel_T>
-		inline bool isBlack(const Pixel_T & color) const
+		inline bool isBlackRow(int y, int firstSegment, int endSegment) const
+		{
+			return _summaries.rowMax(y, firstSegment, endSegment) < _blackborderThreshold;
+		}
+
+		///
+		/// Checks if a column of the last scanned image is considered black within the given column segments
+		///
+		/// @param[in] x             The column
+		/// @param[in] firstSegment  The first column segment (thirds of the height)
+		/// @param[in] endSegment    The segment after the last one
+		///
+		/// @return True if all pixels are considered black else false
+		///
+		inline bool isBlackColumn(int x, int firstSegment, int endSegment) const
 		{
-			// Return the simple compare of the color against black
-			return color.red < _blackborderThreshold && color.green < _blackborderThreshold && color.blue < _blackborderThreshold;
+			return _summaries.columnMax(x, firstSegment, endSegment) < _blackborderThreshold;
 		}
 
 	private:
 		/// Threshold for the black-border detector [0 .. 255]
 		const uint8_t _blackborderThreshold;
 
+		/// Line summaries of the last image, kept to reuse their buffers
+		mutable BlackBorderLineSummaries _summaries;
 	};
 } // end namespace hyperion
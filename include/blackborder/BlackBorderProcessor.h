@@ -74,15 +74,17 @@ namespace hyperion
 				return true;
 			}
 
-			if (_detectionMode == "default") {
-				imageBorder = _detector->process(image);
-			} else if (_detectionMode == "classic") {
-				imageBorder = _detector->process_classic(image);
-			} else if (_detectionMode == "osd") {
-				imageBorder = _detector->process_osd(image);
-			} else if (_detectionMode == "letterbox") {
-				imageBorder = _detector->process_letterbox(image);
+			if (_detectOnProxy && BlackBorderProxy::isReducing(image))
+			{
+				// detect on the luminance proxy and map the border back to the image
+				_proxy.create(image);
+				imageBorder = _proxy.toImageBorder(detect(_proxy.image()));
 			}
+			else
+			{
+				imageBorder = detect(image);
+			}
+
 			// add blur to the border
 			if (imageBorder.horizontalSize > 0)
 			{
@@ -113,6 +115,33 @@ namespace hyperion
 		/// Hyperion instance
 		Hyperion* _hyperion;
 
+		///
+		/// Detects the border of the given image using the current detection mode
+		///
+		/// @param image The image to detect the border of
+		///
+		/// @return The detected border
+		///
+		template <typename Pixel_T>
+		BlackBorder detect(const Image<Pixel_T> & image) const
+		{
+			BlackBorder imageBorder;
+			imageBorder.unknown = false;
+			imageBorder.horizontalSize = 0;
+			imageBorder.verticalSize = 0;
+
+			if (_detectionMode == "default") {
+				imageBorder = _detector->process(image);
+			} else if (_detectionMode == "classic") {
+				imageBorder = _detector->process_classic(image);
+			} else if (_detectionMode == "osd") {
+				imageBorder = _detector->process_osd(image);
+			} else if (_detectionMode == "letterbox") {
+				imageBorder = _detector->process_letterbox(image);
+			}
+			return imageBorder;
+		}
+
 		///
 		/// Updates the current border based on the newly detected border. Returns true if the
 		/// current border has changed.
@@ -143,6 +172,12 @@ namespace hyperion
 		/// The black-border detector
 		BlackBorderDetector* _detector;
 
+		/// Flag to detect the border of large images on a luminance proxy
+		bool _detectOnProxy;
+
+		/// The luminance proxy of the last image
+		BlackBorderProxy _proxy;
+
 		/// The current detected border
 		BlackBorder _currentBorder;
 
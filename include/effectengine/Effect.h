@@ -24,6 +24,9 @@ public:
 
 	friend class EffectModule;
 
+	/// Interval a hidden effect checks for getting visible or interrupted [ms]
+	static constexpr int HIDDEN_POLL_INTERVAL_MS = 50;
+
 	Effect(Hyperion *hyperion
 				, int priority
 				, int timeout
@@ -61,6 +64,17 @@ public:
 	int getRemaining() const;
 
 
+	///
+	/// @brief Set, if the effect is hidden behind a higher priority
+	///
+	void setHidden(bool hidden) { _hidden = hidden; }
+
+	///
+	/// @brief Pause the calling effect thread, while the effect is hidden and not interrupted.
+	///        The effect continues where it paused when it gets visible again.
+	///
+	void waitWhileHidden();
+
 	QString getScript() const { return _script; }
 	QString getName() const { return _name; }
 
@@ -98,6 +112,8 @@ private:
 	Logger *_log;
 	// Reflects whenever this effects should interrupt (timeout or external request)
 	std::atomic<bool> _interupt {};
+	// Reflects whenever this effect is hidden behind a higher priority
+	std::atomic<bool> _hidden {};
 
 	QSize           _imageSize;
 	QImage          _image;
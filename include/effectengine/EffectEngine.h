@@ -99,6 +99,12 @@ private slots:
 	///
 	void handleUpdatedEffectList();
 
+	///
+	/// @brief Pause the effects hidden behind the visible priority, continue the others
+	/// @param priority  The visible priority
+	///
+	void handleVisiblePriorityChange(int priority);
+
 private:
 	/// Run the specified effect on the given priority channel and optionally specify a timeout
 	int runEffectScript(const QString &script
@@ -72,6 +72,11 @@ public:
 	///
 	bool setPixelDecimation(int pixelDecimation) override;
 
+	///
+	/// @brief  Apply new pixel decimation mode
+	///
+	void setPixelDecimationAveraging(bool averaging) override;
+
 private:
 	/**
 	 * Returns true if video is playing over the amlogic chip
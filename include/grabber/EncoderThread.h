@@ -1,12 +1,20 @@
 #ifndef ENCODERTHREAD_H
 #define ENCODERTHREAD_H
 
+// STL includes
+#include <map>
+#include <utility>
+
 // Qt includes
 #include <QThread>
+#include <QMutex>
+#include <QElapsedTimer>
 
 // util includes
 #include <utils/PixelFormat.h>
 #include <utils/ImageResampler.h>
+#include <utils/FrameDecoderStatistics.h>
+#include <utils/Logger.h>
 
 // Determine the cmake options
 #include <HyperionConfig.h>
@@ -15,6 +23,11 @@
 #ifdef HAVE_TURBO_JPEG
 	#include <turbojpeg.h>
 	#include <jconfig.h>
+
+	// Partial decompression of a cropping region (TurboJPEG 3 API)
+	#if LIBJPEG_TURBO_VERSION_NUMBER >= 3000000
+		#define MJPEG_PARTIAL_DECOMPRESSION
+	#endif
 #endif
 
 constexpr int DEFAULT_THREAD_COUNT {1};
@@ -27,29 +40,76 @@ public:
 	explicit EncoderThread();
 	~EncoderThread() override;
 
+	///
+	/// Prepares the next frame to be processed
+	///
+	/// @param[in] sharedData  The frame data of the capture device
+	/// @param[in] borrowData  If true, the frame data is processed in place and has to stay valid until the frame was processed,
+	///                        e.g. a dequeued device buffer which is re-queued afterwards.
+	///                        Otherwise it is copied to a buffer kept by the thread, which grows with the frame size only.
+	/// @param[in] dmabufFd    The DMABUF file descriptor the frame data is mapped from or -1.
+	///                        CPU access to the frame data is synchronised with the device through it.
+	/// @param[in] metadata    The metadata of the frame (capture time, sequence number counted by the grabber, source),
+	///                        set on the decoded image
+	/// @param[in] sequence    The sequence number of the frame handed to the threads, handed back by frameProcessed()
+	///
+	/// The thread is busy from now on, until the frame was processed.
+	///
 	void setup(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation);
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool pixelDecimationAveraging,
+		bool borrowData, int dmabufFd, const ImageMetadata& metadata, quint64 sequence);
 
-	void process();
+	///
+	/// Decodes the frame set up before and emits frameProcessed(), also if decoding failed
+	///
+	Q_INVOKABLE void process();
 
 	bool isBusy() { return _busy; }
 	QAtomicInt _busy = false;
 
 signals:
-	void newFrame(const Image<ColorRgb>& data);
+	///
+	/// @param[in] sequence  The sequence number of the frame
+	/// @param[in] image     The decoded image
+	/// @param[in] decoded   False, if the frame could not be decoded
+	///
+	void frameProcessed(quint64 sequence, const Image<ColorRgb>& image, bool decoded);
 
 private:
+	///
+	/// Ensures the given buffer holds at least the given size, it is only reallocated when growing
+	///
+	static bool reserve(uint8_t*& buffer, size_t& capacity, size_t size);
+	static void release(uint8_t*& buffer, size_t& capacity);
+
+	///
+	/// Starts or ends reading a DMABUF by the CPU, so caches are coherent with the device's writes
+	///
+	static void syncDmabuf(int dmabufFd, bool start);
+
 	PixelFormat _pixelFormat;
+	/// Frame data to be processed, either the borrowed device buffer or one of the buffers below
+	uint8_t* _frameData;
+	/// DMABUF the borrowed frame data is mapped from or -1
+	int _dmabufFd;
+	/// Copy of the frame data, if it is not borrowed
 	uint8_t* _localData;
-	int	_scalingFactorsCount;
+	size_t _localDataCapacity;
+	/// Output of the lossless MJPEG transformation (cropping, flipping)
+	uint8_t* _transformData;
+	size_t _transformDataCapacity;
+	/// Scaled MJPEG frame, if it is decimated or cropped further by the resampler
+	uint8_t* _decodeData;
+	size_t _decodeDataCapacity;
 	int	_width;
 	int	_height;
 	int	_lineLength;
 	int	_currentFrame;
 	int	_pixelDecimation;
+	bool _pixelDecimationAveraging;
 	unsigned long _size;
 	int	_cropLeft;
 	int _cropTop;
@@ -59,15 +119,18 @@ private:
 	FlipMode _flipMode;
 	VideoMode _videoMode;
 	bool _doTransform;
+	ImageMetadata _metadata;
+	quint64 _sequence;
 
 	ImageResampler		_imageResampler;
 
 #ifdef HAVE_TURBO_JPEG
+	/// Resamples the scaled MJPEG frame
+	ImageResampler		_mjpegResampler;
 	tjhandle			_tjInstance;
-	tjscalingfactor*	_scalingFactors;
 	tjtransform*		_xform;
 
-	void processImageMjpeg();
+	bool processImageMjpeg(Image<ColorRgb>& image);
 	bool onError(const QString context) const;
 #endif
 };
@@ -96,14 +159,16 @@ public:
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool pixelDecimationAveraging,
+		bool borrowData, int dmabufFd, const ImageMetadata& metadata, quint64 sequence)
 	{
 		auto encThread = qobject_cast<EncoderThread*>(_thread);
 		if (encThread != nullptr)
 			encThread->setup(pixelFormat, sharedData,
 				size, width, height, lineLength,
 				cropLeft, cropTop, cropBottom, cropRight,
-				videoMode, flipMode, pixelDecimation);
+				videoMode, flipMode, pixelDecimation, pixelDecimationAveraging,
+				borrowData, dmabufFd, metadata, sequence);
 	}
 
 	bool isBusy()
@@ -117,9 +182,10 @@ public:
 
 	void process()
 	{
+		// Decoded in the thread's event loop, the result is delivered by EncoderThread::frameProcessed
 		auto encThread = qobject_cast<EncoderThread*>(_thread);
 		if (encThread != nullptr)
-			encThread->process();
+			QMetaObject::invokeMethod(encThread, "process", Qt::QueuedConnection);
 	}
 
 protected:
@@ -130,15 +196,31 @@ protected:
 	}
 };
 
+///
+/// Distributes the frames of a grabber to the encoder threads and delivers the decoded images in capture order.
+/// Frames are numbered when handed to a thread. A frame decoded before an earlier one is held back until the earlier
+/// one was decoded, or, if "latest frame wins" is enabled, delivered immediately and the earlier ones are dropped.
+///
 class EncoderThreadManager : public QObject
 {
     Q_OBJECT
 public:
-	explicit EncoderThreadManager(QObject *parent = nullptr)
+	///
+	/// @param[in] log     The grabber's logger, MJPEG decoding times are reported to
+	/// @param[in] parent  The grabber
+	///
+	explicit EncoderThreadManager(Logger* log, QObject *parent = nullptr)
 		: QObject(parent)
 		, _threadCount(static_cast<unsigned long>(qMax(QThread::idealThreadCount(), DEFAULT_THREAD_COUNT)))
 		, _threads(nullptr)
+		, _log(log)
+		, _loggedStatistics()
+		, _sequence(0)
+		, _nextSequence(1)
+		, _latestFrameWins(false)
 	{
+		qRegisterMetaType<Image<ColorRgb>>("Image<ColorRgb>");
+
 		_threads = new Thread<EncoderThread>*[_threadCount];
 		for (unsigned long i = 0; i < _threadCount; i++)
 		{
@@ -162,25 +244,71 @@ public:
 		}
 	}
 
-	void start()
-	{
-		if (_threads != nullptr)
-			for (unsigned long  i = 0; i < _threadCount; i++)
-				connect(_threads[i]->thread(), &EncoderThread::newFrame, this, &EncoderThreadManager::newFrame);
-	}
+	void start();
 
-	void stop()
-	{
-		if (_threads != nullptr)
-			for(unsigned long  i = 0; i < _threadCount; i++)
-				disconnect(_threads[i]->thread(), nullptr, nullptr, nullptr);
-	}
+	///
+	/// Stops delivering frames. Returns after all frames handed to the threads were processed,
+	/// so borrowed frame data is not accessed any more.
+	///
+	void stop();
+
+	///
+	/// Hands a frame to an idle encoder thread, see EncoderThread::setup()
+	///
+	/// @return The sequence number of the frame or 0, if all threads were busy and the frame was dropped
+	///
+	quint64 process(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool pixelDecimationAveraging,
+		bool borrowData, int dmabufFd, const ImageMetadata& metadata);
+
+	///
+	/// @param[in] enable  Deliver a decoded frame immediately and drop earlier frames still decoded,
+	///                    instead of waiting for them to deliver all frames in order
+	///
+	void setLatestFrameWins(bool enable) { _latestFrameWins = enable; }
 
 	unsigned long _threadCount;
 	Thread<EncoderThread>**	_threads;
 
 signals:
 	void newFrame(const Image<ColorRgb>& data);
+
+	///
+	/// Emitted when a frame was processed, i.e. borrowed frame data is not accessed any more
+	///
+	/// @param[in] sequence  The sequence number returned by process()
+	///
+	void frameReleased(quint64 sequence);
+
+private slots:
+	void onFrameProcessed(quint64 sequence, const Image<ColorRgb>& image, bool decoded);
+
+private:
+	/// Interval MJPEG decoding times are reported in [ms]
+	static constexpr qint64 DECODE_TIME_LOG_INTERVAL = 60000;
+
+	///
+	/// Logs the average MJPEG decoding time per scale factor since the last report
+	///
+	void logDecodeTimes();
+
+	Logger* _log;
+	QElapsedTimer _decodeTimeLogTimer;
+	/// Statistics at the last report
+	FrameDecoderStatistics::Statistics _loggedStatistics;
+
+	/// Guards _sequence, frames may be handed over by a capture callback thread
+	QMutex _sequenceMutex;
+	/// Sequence number of the last frame handed to a thread
+	quint64 _sequence;
+	/// Sequence number of the next frame to be delivered (only used by the manager's thread)
+	quint64 _nextSequence;
+	bool _latestFrameWins;
+	/// Decoded frames held back until the earlier frames were decoded, by sequence number
+	std::map<quint64, std::pair<Image<ColorRgb>, bool>> _heldFrames;
 };
 
 #endif //ENCODERTHREAD_H
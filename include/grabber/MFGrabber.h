@@ -71,6 +71,7 @@ public:
 	void setSignalThreshold(double redSignalThreshold, double greenSignalThreshold, double blueSignalThreshold, int noSignalCounterThreshold);
 	void setSignalDetectionOffset( double verticalMin, double horizontalMin, double verticalMax, double horizontalMax);
 	void setSignalDetectionEnable(bool enable);
+	void setLatestFrameWins(bool enable);
 	bool reload(bool force = false);
 
 	///
@@ -121,7 +122,8 @@ private:
 	bool										_signalDetectionEnabled,
 												_noSignalDetected,
 												_initialized,
-												_reload;
+												_reload,
+												_latestFrameWins;
 	double										_x_frac_min,
 												_y_frac_min,
 												_x_frac_max,
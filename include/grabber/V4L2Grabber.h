@@ -78,6 +78,7 @@ public:
 	void setSignalDetectionOffset( double verticalMin, double horizontalMin, double verticalMax, double horizontalMax);
 	void setSignalDetectionEnable(bool enable);
 	void setCecDetectionEnable(bool enable);
+	void setLatestFrameWins(bool enable);
 	bool reload(bool force = false);
 
 	QRectF getSignalDetectionOffset() const { return QRectF(_x_frac_min, _y_frac_min, _x_frac_max, _y_frac_max); } //used from hyperion-v4l2
@@ -107,6 +108,7 @@ signals:
 
 private slots:
 	int read_frame();
+	void releaseFrameBuffer(quint64 sequence);
 
 private:
 	bool init();
@@ -120,7 +122,8 @@ private:
 	void uninit_device();
 	void start_capturing();
 	void stop_capturing();
-	bool process_image(const void *p, int size);
+	quint64 process_image(const void *p, int size, bool borrowData, int dmabufFd, qint64 captureTime);
+	void queue_buffer(unsigned int index);
 	int xioctl(int request, void *arg);
 	int xioctl(int fileDescriptor, int request, void *arg);
 
@@ -146,6 +149,8 @@ private:
 	{
 			void   *start;
 			size_t  length;
+			/// DMABUF file descriptor, if the buffer is exported and mapped through it, otherwise -1
+			int     dmabufFd;
 	};
 
 private:
@@ -157,6 +162,9 @@ private:
 	io_method           _ioMethod;
 	int                 _fileDescriptor;
 	std::vector<buffer> _buffers;
+	/// Dequeued buffers decoded in place, by frame sequence number, re-queued when the frame was processed
+	QMap<quint64, unsigned int> _borrowedBuffers;
+	bool _latestFrameWins;
 
 	PixelFormat _pixelFormat, _pixelFormatConfig;
 	int         _lineLength;
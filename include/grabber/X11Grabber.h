@@ -64,6 +64,11 @@ public:
 	///
 	bool setPixelDecimation(int pixelDecimation) override;
 
+	///
+	/// @brief Apply new pixel decimation mode, XRender averages with a box filter
+	///
+	void setPixelDecimationAveraging(bool averaging) override;
+
 	///
 	/// Set the crop values
 	/// @param  cropLeft    Left pixel crop
@@ -37,6 +37,7 @@ public:
 	void setVideoMode(VideoMode mode) override;
 	bool setWidthHeight(int width, int height) override { return true; }
 	bool setPixelDecimation(int pixelDecimation) override;
+	void setPixelDecimationAveraging(bool averaging) override;
 	void setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom) override;
 
 	///
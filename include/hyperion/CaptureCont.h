@@ -4,6 +4,10 @@
 #include <utils/settings.h>
 #include <utils/Components.h>
 #include <utils/Image.h>
+#include <utils/LatestValueSlotTable.h>
+
+#include <QPair>
+#include <QSharedPointer>
 
 class Hyperion;
 class QTimer;
@@ -17,11 +21,17 @@ class CaptureCont : public QObject
 	Q_OBJECT
 public:
 	CaptureCont(Hyperion* hyperion);
+	~CaptureCont() override;
 
 	void setSystemCaptureEnable(bool enable);
 	void setV4LCaptureEnable(bool enable);
 	void setAudioCaptureEnable(bool enable);
 
+	///
+	/// @brief Get the statistics of the images published by the capture interfaces (thread safe)
+	///
+	LatestValueSlotStatistics getImageSlotStatistics() const;
+
 private slots:
 	///
 	/// @brief Handle component state change of V4L and SystemCapture
@@ -55,6 +65,12 @@ private slots:
 	///
 	void handleAudioImage(const QString& name, const Image<ColorRgb>& image);
 
+	///
+	/// @brief forward the image posted last by a capture interface, if its capture is still enabled
+	/// @param component  The component of the capture interface
+	///
+	void deliverImage(int component);
+
 	///
 	/// @brief Is called from _v4lInactiveTimer to set source after specific time to inactive
 	///
@@ -70,25 +86,60 @@ private slots:
 	///
 	void setSystemInactive();
 
+	///
+	/// @brief Tell the capture interfaces, if their images got hidden behind a higher priority or visible again
+	/// @param priority  The visible priority
+	///
+	void handleVisiblePriorityChange(int priority);
+
 private:
+	/// Slots handing over the latest image and its source name of a capture interface, indexed by component
+	using ImageSlotTable = LatestValueSlotTable<QPair<QString, Image<ColorRgb>>>;
+
+	///
+	/// @brief Connect a capture signal of the GlobalSignals, which publishes the images to be forwarded in the instance's thread.
+	/// The images are published by the capture thread, an image still pending of the capture interface is replaced, so a
+	/// saturated instance processes the newest image.
+	/// @param signal     The capture signal
+	/// @param component  The component of the capture interface
+	///
+	template <typename Signal_T>
+	void connectImageSignal(Signal_T signal, hyperion::Components component);
+
+	///
+	/// @brief Tell a capture interface on change, if its images are hidden behind the visible priority
+	/// @param component        The component of the capture interface
+	/// @param enabled          The capture state
+	/// @param capturePriority  The priority of the capture
+	/// @param visiblePriority  The visible priority
+	/// @param hidden           The state told last, updated on change
+	///
+	void updateSourceVisibility(hyperion::Components component, bool enabled, int capturePriority, int visiblePriority, bool& hidden);
+
 	/// Hyperion instance
 	Hyperion* _hyperion;
 
+	/// The latest image and its source name published per capture component, shared with the capture connections
+	QSharedPointer<ImageSlotTable> _imageSlots;
+
 	/// Reflect state of System capture and prio
 	bool _systemCaptEnabled;
 	quint8 _systemCaptPrio;
 	QString _systemCaptName;
 	QTimer* _systemInactiveTimer;
+	bool _systemCaptHidden;
 
 	/// Reflect state of v4l capture and prio
 	bool _v4lCaptEnabled;
 	quint8 _v4lCaptPrio;
 	QString _v4lCaptName;
 	QTimer* _v4lInactiveTimer;
+	bool _v4lCaptHidden;
 
 	/// Reflect state of audio capture and prio
 	bool _audioCaptEnabled;
 	quint8 _audioCaptPrio;
 	QString _audioCaptName;
 	QTimer* _audioInactiveTimer;
+	bool _audioCaptHidden;
 };
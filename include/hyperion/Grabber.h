@@ -73,6 +73,12 @@ public:
 	///
 	virtual bool setPixelDecimation(int pixelDecimation);
 
+	///
+	/// @brief Apply new pixel decimation mode
+	/// @param averaging True, to average all pixels reduced by the decimation, false to sample one pixel of them
+	///
+	virtual void setPixelDecimationAveraging(bool averaging);
+
 	///
 	/// @brief Apply display index (used from qt)
 	///
@@ -109,6 +115,11 @@ public:
 	///
 	int getPixelDecimation() const { return _pixelDecimation; }
 
+	///
+	/// @brief  Get pixel decimation mode
+	///
+	bool getPixelDecimationAveraging() const { return _pixelDecimationAveraging; }
+
 	QString getGrabberName() const { return _grabberName; }
 
 protected slots:
@@ -139,6 +150,9 @@ protected:
 	/// Image size decimation
 	int _pixelDecimation;
 
+	/// Average the pixels reduced by the decimation instead of sampling one of them
+	bool _pixelDecimationAveraging;
+
 	/// the used Flip Mode
 	FlipMode _flipMode;
 
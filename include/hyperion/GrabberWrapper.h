@@ -6,10 +6,13 @@
 #include <QString>
 #include <QStringList>
 #include <QMultiMap>
+#include <QSet>
 
 #include <utils/Logger.h>
 #include <utils/Components.h>
 #include <utils/Image.h>
+#include <utils/InputThrottle.h>
+#include <utils/LatencyStatistics.h>
 #include <utils/ColorRgb.h>
 #include <utils/VideoMode.h>
 #include <utils/PixelFormat.h>
@@ -91,14 +94,15 @@ public:
 	{
 		unsigned w = grabber.getImageWidth();
 		unsigned h = grabber.getImageHeight();
-		if ( _image.width() != w || _image.height() != h)
-		{
-			_image.resize(w, h);
-		}
 
+		// The previous frame is still referenced by its receivers, grab into new data instead of copying it
+		_image.reset(w, h);
+
+		const qint64 captureTime = LatencyStatistics::now();
 		int ret = grabber.grabFrame(_image);
 		if (ret >= 0)
 		{
+			_image.setMetadata(ImageMetadata(captureTime, ++_frameSequence, _sourceId));
 			emit systemImage(_grabberName, _image);
 			return true;
 		}
@@ -151,6 +155,9 @@ private slots:
 	void handleSourceRequest(hyperion::Components component, int hyperionInd, bool listen);
 
 	///
+	/// @brief Handle a source visibility event from Hyperion.
+	/// Will throttle the grabber, while its images are hidden behind a higher priority on all listening instances
+	void handleSourceVisibility(hyperion::Components component, int hyperionInd, bool visible);
 
 
 protected:
@@ -174,6 +181,21 @@ protected:
 	///
 	void updateTimer(int interval);
 
+	///
+	/// @brief Get the capture component of the grabber
+	///
+	hyperion::Components getComponent() const;
+
+	///
+	/// @brief Evaluate, if the images are hidden on all listening instances, and adapt the capture rate
+	///
+	void updateThrottle();
+
+	///
+	/// @brief Apply the update rate to the timer, a hidden grabber captures with the keep-alive interval at most
+	///
+	void applyTimerInterval();
+
 
 	QString _grabberName;
 
@@ -186,8 +208,18 @@ protected:
 	/// The calculated update rate [ms]
 	int _updateInterval_ms;
 
+	/// The listening instances which show a higher priority than the grabber's images
+	QSet<int> _hiddenInstances;
+
+	/// Throttles the frames forwarded while the grabber is hidden, to be checked by grabbers pushing frames
+	InputThrottle _throttle;
+
 	Grabber *_ggrabber;
 
 	/// The image used for grabbing frames
 	Image<ColorRgb> _image;
+
+	/// The source id of the grabbed images and the sequence number of the last one
+	quint32 _sourceId;
+	quint64 _frameSequence;
 };
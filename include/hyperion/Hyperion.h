@@ -17,6 +17,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/Components.h>
 #include <utils/VideoMode.h>
+#include <utils/LatestValueSlot.h>
 
 // Hyperion includes
 #include <hyperion/LedString.h>
@@ -109,6 +110,38 @@ public:
 
 	bool getReadOnlyMode() {return _readOnlyMode; }
 
+	///
+	/// @brief Get the statistics of the images published by postInputImage() and the capture interface (thread safe)
+	/// @return The number of images published and coalesced, as a later image of the same input was published before they were processed
+	///
+	LatestValueSlotStatistics getInputSlotStatistics() const;
+
+	///
+	/// @brief Get the image slots of the priorities, which postInputImage() publishes to (thread safe).
+	/// 	   A producer keeping the reference may publish from its own thread while the instance is destroyed.
+	/// @return The table of the image slots
+	///
+	QSharedPointer<PriorityMuxer::ImageSlotTable> getInputImageSlots() const;
+
+	///
+	/// @brief   Posts the image of a priority to the image slots of an instance, see postInputImage(). It can be called from any thread,
+	/// 		 even after the instance stopped: the images are dropped then.
+	/// @param  imageSlots   The image slots of the instance
+	/// @param  priority     The priority to update
+	/// @param  image        The new image
+	/// @param  timeout_ms   The new timeout (defaults to -1 endless)
+	/// @param  clearEffect  Should be true when NOT called from an effect
+	///
+	static void postInputImage(const QSharedPointer<PriorityMuxer::ImageSlotTable>& imageSlots, int priority, const Image<ColorRgb>& image, int64_t timeout_ms = PriorityMuxer::ENDLESS, bool clearEffect = true);
+
+	///
+	/// @brief   Posts a clear of a priority to an instance, see postClear(). It can be called from any thread, even after the instance stopped.
+	/// @param  imageSlots     The image slots of the instance
+	/// @param  priority       The priority channel. -1 clears all priorities
+	/// @param  forceClearAll  Force the clear
+	///
+	static void postClear(const QSharedPointer<PriorityMuxer::ImageSlotTable>& imageSlots, int priority, bool forceClearAll = false);
+
 public slots:
 
 	///
@@ -155,6 +188,28 @@ public slots:
 	///
 	bool setInputImage(int priority, const Image<ColorRgb>& image, int64_t timeout_ms = PriorityMuxer::ENDLESS, bool clearEffect = true);
 
+	///
+	/// @brief   Posts the image of a priority to be set by setInputImage() in the instance's thread, can be called from any thread.
+	/// 		 The image is published to the priority's slot of the muxer without blocking the instance. An image posted while an
+	/// 		 earlier image of the priority is still pending replaces it, so images do not pile up when processing is slower
+	/// 		 than the producer and the newest image of a priority is always processed next.
+	/// 		 Producers which may outlive the instance use the static overload with their own reference of getInputImageSlots().
+	/// @param  priority     The priority to update
+	/// @param  image        The new image
+	/// @param  timeout_ms   The new timeout (defaults to -1 endless)
+	/// @param  clearEffect  Should be true when NOT called from an effect
+	///
+	void postInputImage(int priority, const Image<ColorRgb>& image, int64_t timeout_ms = PriorityMuxer::ENDLESS, bool clearEffect = true);
+
+	///
+	/// @brief   Posts a clear of a priority to be run by clear() in the instance's thread, can be called from any thread.
+	/// 		 Images posted by the calling thread afterwards are set only after the clear ran, also when the instance
+	/// 		 is still processing an earlier image of the priority.
+	/// @param  priority       The priority channel. -1 clears all priorities
+	/// @param  forceClearAll  Force the clear
+	///
+	void postClear(int priority, bool forceClearAll = false);
+
 	///
 	/// Writes a single color to all the leds for the given time and priority
 	/// Registers comp color or provided type against muxer
@@ -494,7 +549,10 @@ signals:
 	///
 	/// @brief Emits whenever new data should be pushed to the LedDeviceWrapper which forwards it to the threaded LedDevice
 	///
-	void ledDeviceData(const std::vector<ColorRgb>& ledValues);
+	/// @param ledValues    The RGB-color per led
+	/// @param captureTime  The capture time of the image the colors are derived from, 0 if unknown or already written (see Image::captureTime())
+	///
+	void ledDeviceData(const std::vector<ColorRgb>& ledValues, qint64 captureTime);
 
 	///
 	/// @brief Emits whenever new untransformed ledColos data is available, reflects the current visible device
@@ -536,6 +594,20 @@ private slots:
 	///
 	void handleSourceAvailability(int priority);
 
+	///
+	/// @brief Sets the image published last to the slot of the given priority by postInputImage()
+	/// @param priority   The priority
+	///
+	void deliverInputImage(int priority);
+
+	///
+	/// @brief Runs a clear posted by postClear()
+	/// @param priority       The priority channel. -1 clears all priorities
+	/// @param forceClearAll  Force the clear
+	/// @param sequence       The sequence of the clear in the image slots
+	///
+	void runPostedClear(int priority, bool forceClearAll, quint32 sequence);
+
 private:
 	friend class HyperionDaemon;
 	friend class HyperionIManager;
@@ -566,6 +638,9 @@ private:
 	/// The priority muxer
 	PriorityMuxer* _muxer;
 
+	/// The image slots of the muxer, kept until the instance is destroyed
+	QSharedPointer<PriorityMuxer::ImageSlotTable> _inputImageSlots;
+
 	/// The adjustment from raw colors to led colors
 	MultiColorAdjustment * _raw2ledAdjustment;
 
@@ -601,6 +676,9 @@ private:
 	/// buffer for leds (with adjustment)
 	std::vector<ColorRgb> _ledBuffer;
 
+	/// The capture time of the image written last without smoothing, its re-evaluations are no new latency samples
+	qint64 _lastWrittenCaptureTime;
+
 	VideoMode _currVideoMode = VideoMode::VIDEO_2D;
 
 #if defined(ENABLE_BOBLIGHT_SERVER)
@@ -5,10 +5,13 @@
 
 // Utils includes
 #include <utils/Image.h>
+#include <utils/LruCache.h>
+#include <utils/WorkerPool.h>
 
 // Hyperion includes
 #include <hyperion/LedString.h>
 #include <hyperion/ImageToLedsMap.h>
+#include <hyperion/ImageToLedsMapBuilder.h>
 #include <utils/Logger.h>
 
 // settings
@@ -18,6 +21,7 @@
 #include <blackborder/BlackBorderProcessor.h>
 
 class Hyperion;
+class QThread;
 
 ///
 /// The ImageProcessor translates an RGB-image to RGB-values for the LEDs. The processing is
@@ -51,6 +55,8 @@ public:
 
 	///
 	/// @brief Update the led string (eg on settings change)
+	/// If the number of LEDs is unchanged, the mapping is updated in the background and replaces the current
+	/// one once built, otherwise it is updated immediately. Only the areas of changed LEDs are computed.
 	///
 	void setLedString(const LedString& ledString);
 
@@ -70,6 +76,18 @@ public:
 	/// @param[in] level  The accuracy level (0-4)
 	void setAccuracyLevel(int level);
 
+	///
+	/// Enable or disable the full resolution refinement of dominant colors
+	///
+	/// @param[in] enable  True to use the most frequent exact color of the dominant color bin
+	void setDominantColorRefinement(bool enable);
+
+	///
+	/// Set the number of threads processing the LEDs in parallel
+	///
+	/// @param[in] threads  The number of threads, 1 to process all LEDs on the instance's thread
+	void setWorkerThreads(int threads);
+
 	/// Returns the current _userMappingType, this may not be the current applied type!
 	int getUserLedMappingType() const { return _userMappingType; }
 
@@ -149,6 +167,9 @@ public:
 			case 4:
 				colors = _imageToLedColors->getDominantLedColorAdv(image);
 				break;
+			case 5:
+				colors = _imageToLedColors->getMeanLedColorIntegral(image);
+				break;
 			default:
 				colors = _imageToLedColors->getMeanLedColor(image);
 			}
@@ -194,6 +215,9 @@ public:
 			case 4:
 				_imageToLedColors->getDominantLedColorAdv(image, ledColors);
 				break;
+			case 5:
+				_imageToLedColors->getMeanLedColorIntegral(image, ledColors);
+				break;
 			default:
 				_imageToLedColors->getMeanLedColor(image, ledColors);
 			}
@@ -215,7 +239,86 @@ public:
 	/// @return true if the parameters could be retrieved
 	bool getScanParameters(size_t led, double & hscanBegin, double & hscanEnd, double & vscanBegin, double & vscanEnd) const;
 
+	///
+	/// Key of a cached mapping, the mapping depends on the image geometry and the reduced pixel set factor only
+	///
+	struct MappingKey
+	{
+		int width;
+		int height;
+		int horizontalBorder;
+		int verticalBorder;
+		int reducedPixelSetFactor;
+
+		bool operator==(const MappingKey& other) const
+		{
+			return width == other.width && height == other.height
+				&& horizontalBorder == other.horizontalBorder && verticalBorder == other.verticalBorder
+				&& reducedPixelSetFactor == other.reducedPixelSetFactor;
+		}
+	};
+
+	using MappingCache = LruCache<MappingKey, QSharedPointer<hyperion::ImageToLedsMap>>;
+
+	///
+	/// Returns the statistics of the mapping cache (thread safe)
+	///
+	MappingCache::Statistics getMappingCacheStatistics() const { return _mappingCache.statistics(); }
+
 private:
+	/// Number of mappings kept for image sizes and borders used recently
+	static constexpr quint32 MAPPING_CACHE_CAPACITY = 4;
+	/// Number of borders whose usage is counted
+	static constexpr size_t BORDER_STATISTICS_CAPACITY = 16;
+	/// Number of times a border has to be used to be considered frequent, i.e. to be built in advance
+	static constexpr quint32 FREQUENT_BORDER_COUNT = 2;
+
+	///
+	/// Returns the cache key of the given mapping
+	///
+	MappingKey mappingKey(const hyperion::ImageToLedsMap& map) const;
+
+	///
+	/// Returns the cache key of the given image geometry
+	///
+	MappingKey mappingKey(int width, int height, int horizontalBorder, int verticalBorder) const;
+
+	///
+	/// Checks if the given keys describe the same image size and border, regardless of the reduced pixel set factor
+	///
+	static bool sameGeometry(const MappingKey& key, const MappingKey& other);
+
+	///
+	/// Switches to the mapping of a newly detected border. A cached mapping is activated instantly, otherwise
+	/// the mapping is built in the background while the current one is kept.
+	///
+	/// @param[in] width             The width of the image
+	/// @param[in] height            The height of the image
+	/// @param[in] horizontalBorder  The size of the horizontal border
+	/// @param[in] verticalBorder    The size of the vertical border
+	///
+	void switchBorder(int width, int height, int horizontalBorder, int verticalBorder);
+
+	///
+	/// Counts the usage of a border, evicting the least used border if the statistics are full
+	///
+	void countBorder(const MappingKey& key);
+
+	///
+	/// Returns the builder of mappings, started on first use
+	///
+	ImageToLedsMapBuilder* mapBuilder();
+
+	///
+	/// Requests a mapping for the given key to be built in the background
+	///
+	void requestProcessingUnit(const MappingKey& key);
+
+	///
+	/// Builds the mapping of the most frequently used border of the current image size in the background,
+	/// if it is not cached and no other mapping is built
+	///
+	void requestFrequentProcessingUnit();
 
 	void registerProcessingUnit(
 		int width,
@@ -223,6 +326,20 @@ private:
 		int horizontalBorder,
 		int verticalBorder);
 
+	///
+	/// Applies the processing settings to the given mapping and makes it the current one
+	///
+	/// @param[in] map  The new mapping, taking over the processing state of the current one
+	///
+	void activateProcessingUnit(const QSharedPointer<hyperion::ImageToLedsMap>& map);
+
+	///
+	/// Requests an update of the current mapping to the current LED string and reduced pixel set factor.
+	/// If the mapping of another border is built already, this one is requested instead.
+	/// The mapping is built on the builder thread and activated by handleMapBuilt().
+	///
+	void requestProcessingUnitUpdate();
+
 	///
 	/// Performs black-border detection (if enabled) on the given image
 	///
@@ -244,11 +361,11 @@ private:
 
 			if (border.unknown)
 			{
-				registerProcessingUnit(image.width(), image.height(), 0, 0);
+				switchBorder(image.width(), image.height(), 0, 0);
 			}
 			else
 			{
-				registerProcessingUnit(image.width(), image.height(), border.horizontalSize, border.verticalSize);
+				switchBorder(image.width(), image.height(), border.horizontalSize, border.verticalSize);
 			}
 		}
 	}
@@ -256,6 +373,11 @@ private:
 private slots:
 	void handleSettingsUpdate(settings::type type, const QJsonDocument& config);
 
+	///
+	/// Activates the mapping built in the background, if it is still up to date
+	///
+	void handleMapBuilt();
+
 private:
 
 	Logger * _log;
@@ -277,6 +399,29 @@ private:
 
 	int _accuraryLevel;
 	int _reducedPixelSetFactorFactor;
+	bool _dominantColorRefinement;
+
+	/// The worker pool processing the LEDs in parallel, null if disabled
+	QSharedPointer<WorkerPool> _workerPool;
+
+	/// The summed-area table shared by all mappings, only the active one evaluates images
+	QSharedPointer<ImageToLedsMap::IntegralImage> _integralImage;
+
+	/// Builds updated mappings in the background (created on first use)
+	ImageToLedsMapBuilder* _mapBuilder;
+	QThread* _mapBuilderThread;
+	/// Incremented with every mapping built or requested, to discard outdated mappings
+	quint64 _mapGeneration;
+	/// True while a requested mapping is built
+	bool _mapRequestPending;
+	/// The key of the mapping to be active, differs from the current one while its mapping is built
+	MappingKey _activeKey;
+
+	/// Mappings for the current LED string used recently, allows switching between sources of different size without rebuilds
+	MappingCache _mappingCache;
+
+	/// Number of times a border was detected, per image size and border
+	std::vector<std::pair<MappingKey, quint32>> _borderCounts;
 
 	/// Hyperion instance pointer
 	Hyperion* _hyperion;
@@ -3,15 +3,21 @@
 
 // STL includes
 #include <cassert>
+#include <climits>
 #include <memory>
 #include <sstream>
 #include <cmath>
 
+// QT includes
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
 // hyperion-utils includes
 #include <utils/Image.h>
 #include <utils/Logger.h>
 #include <utils/ColorRgbScalar.h>
 #include <utils/ColorSys.h>
+#include <utils/WorkerPool.h>
 
 // hyperion includes
 #include <hyperion/LedString.h>
@@ -19,7 +25,7 @@
 namespace hyperion
 {
 	///
-	/// The ImageToLedsMap holds a mapping of indices into an image to LEDs. It can be used to
+	/// The ImageToLedsMap holds a mapping of image areas to LEDs. It can be used to
 	/// calculate the average (aka mean) or dominant color per LED for a given region.
 	///
 	class ImageToLedsMap : public QObject
@@ -29,9 +35,10 @@ namespace hyperion
 	public:
 
 		///
-		/// Constructs an mapping from the absolute indices in an image to each LED based on the border
-		/// definition given in the list of LEDs. The map holds absolute indices to any given image,
-		/// provided that it is row-oriented.
+		/// Constructs an mapping from the areas in an image to each LED based on the border
+		/// definition given in the list of LEDs. The map holds one row-span description per LED
+		/// (top-left pixel, extent and sampling step) in a single contiguous table, applicable to any
+		/// given image, provided that it is row-oriented.
 		/// The mapping is created purely on size (width and height). The given borders are excluded
 		/// from indexing.
 		///
@@ -54,6 +61,22 @@ namespace hyperion
 				int reducedProcessingFactor = 0,
 				int accuraryLevel = 0);
 
+		///
+		/// Constructs a mapping for an updated list of LEDs, using the image size and borders of the given mapping.
+		/// The areas of LEDs with an unchanged geometry are taken over from the given mapping, only the areas of
+		/// new or changed LEDs are computed. The given mapping is only read and may be used concurrently for processing.
+		///
+		/// @param[in] base             The mapping to take over the image geometry and unchanged areas from
+		/// @param[in] leds             The updated list with led specifications
+		/// @param[in] reducedProcessingFactor Factor to reduce the number of pixels evaluated during processing
+		/// @param[in] accuraryLevel    The accuracy used during processing (only for selected types)
+		///
+		ImageToLedsMap(
+				const ImageToLedsMap & base,
+				const std::vector<Led> & leds,
+				int reducedProcessingFactor,
+				int accuraryLevel);
+
 		///
 		/// Returns the width of the indexed image
 		///
@@ -78,6 +101,46 @@ namespace hyperion
 		/// @param[in] level  The accuracy level (0-4)
 		void setAccuracyLevel (int level);
 
+		///
+		/// Enable or disable the full resolution refinement of dominant colors.
+		/// When disabled, the mean color of the most frequent 12 bit color bin is used.
+		///
+		/// @param[in] enable  True to refine to the most frequent full resolution color
+		void setDominantColorRefinement(bool enable) { _dominantColorRefinement = enable; }
+
+		///
+		/// Set the worker pool used to process the LEDs in parallel.
+		/// The LEDs are split into chunks of a multiple of LED_CHUNK_ALIGNMENT LEDs, the result is identical to sequential processing.
+		///
+		/// @param[in] workerPool  The worker pool or null to process the LEDs sequentially
+		void setWorkerPool(const QSharedPointer<WorkerPool>& workerPool);
+
+		///
+		/// Summed-area table (integral image) of an image, (width+1) x (height+1) entries of red, green, blue sums.
+		/// Used as scratch buffer by getMeanLedColorIntegral, it may be shared by all mappings evaluated by the same thread.
+		///
+		struct IntegralImage
+		{
+			/// The channel sums
+			std::vector<uint32_t> sums;
+			/// Number of entries per row
+			size_t stride {0};
+		};
+
+		///
+		/// Set the summed-area table used by getMeanLedColorIntegral, allows mappings of the same processor
+		/// to share a single table instead of keeping one per mapping.
+		///
+		/// @param[in] integralImage  The summed-area table or null to allocate an own table on first use
+		void setIntegralImage(const QSharedPointer<IntegralImage>& integralImage) { _integralImage = integralImage; }
+
+		///
+		/// Takes over the processing state (the k-means clusters of dominant color advanced) of all LEDs, which
+		/// evaluate the same pixels in the given mapping. Avoids color jumps when replacing a mapping.
+		///
+		/// @param[in] previous  The mapping replaced by this one
+		void takeOverProcessingState(const ImageToLedsMap& previous);
+
 		///
 		/// Determines the mean color for each LED using the LED area mapping given
 		/// at construction.
@@ -89,7 +152,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getMeanLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
 			getMeanLedColor(image, colors);
 			return colors;
 		}
@@ -104,19 +167,17 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getMeanLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_ledAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
 				return;
 			}
 
 			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			processLedAreas(ledColors, [&](const LedArea& area, size_t /*ledIdx*/, int /*chunk*/)
 			{
-				const ColorRgb color = calcMeanColor(image, *colors);
-				*led = color;
-			}
+				return calcMeanColor(image, area);
+			});
 		}
 
 		///
@@ -130,7 +191,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getMeanLedColorSqrt(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
 			getMeanLedColorSqrt(image, colors);
 			return colors;
 		}
@@ -145,19 +206,69 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getMeanLedColorSqrt(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_ledAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
 				return;
 			}
 
 			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			processLedAreas(ledColors, [&](const LedArea& area, size_t /*ledIdx*/, int /*chunk*/)
+			{
+				return calcMeanColorSqrt(image, area);
+			});
+		}
+
+		///
+		/// Determines the mean color for each LED using the LED area mapping given
+		/// at construction. A summed-area table (integral image) of the image is built once,
+		/// the mean of each LED area is then derived from four table reads, independent of the
+		/// area's size. All pixels of an area are evaluated, no pixels are skipped.
+		///
+		/// @param[in] image  The image from which to extract the led colors
+		///
+		/// @return The vector containing the output
+		///
+		template <typename Pixel_T>
+		std::vector<ColorRgb> getMeanLedColorIntegral(const Image<Pixel_T> & image) const
+		{
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
+			getMeanLedColorIntegral(image, colors);
+			return colors;
+		}
+
+		///
+		/// Determines the mean color for each LED using the LED area mapping given
+		/// at construction. A summed-area table (integral image) of the image is built once,
+		/// the mean of each LED area is then derived from four table reads, independent of the
+		/// area's size. All pixels of an area are evaluated, no pixels are skipped.
+		///
+		/// @param[in] image  The image from which to extract the LED colors
+		/// @param[out] ledColors  The vector containing the output
+		///
+		template <typename Pixel_T>
+		void getMeanLedColorIntegral(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
+		{
+			if(_ledAreas.size() != ledColors.size())
 			{
-				const ColorRgb color = calcMeanColorSqrt(image, *colors);
-				*led = color;
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
+				return;
 			}
+
+			// The 32 bit table sums would not be exact for areas of this size anymore
+			if (static_cast<uint64_t>(image.width()) * image.height() > MAX_INTEGRAL_IMAGE_PIXELS)
+			{
+				getMeanLedColor(image, ledColors);
+				return;
+			}
+
+			buildIntegralImage(image);
+
+			// Iterate each led and look up the mean
+			processLedAreas(ledColors, [&](const LedArea& area, size_t /*ledIdx*/, int /*chunk*/)
+			{
+				return calcMeanColorIntegral(area);
+			});
 		}
 
 		///
@@ -170,7 +281,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getUniLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
 			getUniLedColor(image, colors);
 			return colors;
 		}
@@ -184,9 +295,9 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getUniLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_ledAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
 				return;
 			}
 
@@ -207,7 +318,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
 			getDominantLedColor(image, colors);
 			return colors;
 		}
@@ -223,19 +334,17 @@ namespace hyperion
 		void getDominantLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
 			// Sanity check for the number of LEDs
-			if(_colorsMap.size() != ledColors.size())
+			if(_ledAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
 				return;
 			}
 
-			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			// Iterate each led and compute the dominant color, each chunk of LEDs uses its own histogram
+			processLedAreas(ledColors, [&](const LedArea& area, size_t /*ledIdx*/, int chunk)
 			{
-				const ColorRgb color = calculateDominantColor(image, *colors);
-				*led = color;
-			}
+				return calculateDominantColor(image, area, _histograms[static_cast<size_t>(chunk)]);
+			});
 		}
 
 		///
@@ -249,7 +358,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantLedColorAdv(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_ledAreas.size(), ColorRgb{0,0,0});
 			getDominantLedColorAdv(image, colors);
 			return colors;
 		}
@@ -265,21 +374,61 @@ namespace hyperion
 		void getDominantLedColorAdv(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
 			// Sanity check for the number of LEDs
-			if(_colorsMap.size() != ledColors.size())
+			if(_ledAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _ledAreas.size(), ledColors.size());
 				return;
 			}
 
-			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			QElapsedTimer timer;
+			timer.start();
+
+			// Iterate each led and compute the dominant color, seeded with the led's clusters of the previous frame
+			std::vector<KMeansStatistics> chunkStatistics(static_cast<size_t>(_chunkCount));
+			processLedAreas(ledColors, [&](const LedArea& area, size_t ledIdx, int chunk)
+			{
+				return calculateDominantColorAdv(image, area, &_clusterColors[ledIdx * MAX_CLUSTER_COUNT], chunkStatistics[static_cast<size_t>(chunk)]);
+			});
+
+			for (const KMeansStatistics& statistics : chunkStatistics)
 			{
-				const ColorRgb color = calculateDominantColorAdv(image, *colors);
-				*led = color;
+				_kMeansStatistics.clusterings += statistics.clusterings;
+				_kMeansStatistics.iterations += statistics.iterations;
+			}
+			_kMeansStatistics.frames++;
+			_kMeansStatistics.processingTime_ns += timer.nsecsElapsed();
+			if (_kMeansStatistics.frames % KMEANS_STATISTICS_INTERVAL == 0)
+			{
+				Debug(_log, "Dominant color advanced: %.2f iterations per LED on average (maximum %d), %.3f ms per frame",
+					_kMeansStatistics.averageIterations(), KMEANS_MAX_ITERATIONS, _kMeansStatistics.averageProcessingTime_ms());
 			}
 		}
 
+		///
+		/// Statistics of the dominant color advanced (k-means) processing
+		///
+		struct KMeansStatistics
+		{
+			/// Number of frames processed
+			uint64_t frames {0};
+			/// Number of LED areas clustered
+			uint64_t clusterings {0};
+			/// Number of k-means iterations in total
+			uint64_t iterations {0};
+			/// Processing time in total [ns]
+			int64_t processingTime_ns {0};
+
+			double averageIterations() const { return clusterings > 0 ? static_cast<double>(iterations) / clusterings : 0.0; }
+			double averageProcessingTime_ms() const { return frames > 0 ? static_cast<double>(processingTime_ns) / frames / 1e6 : 0.0; }
+		};
+
+		///
+		/// Returns the statistics of the dominant color advanced (k-means) processing
+		///
+		/// @return The statistics accumulated since construction
+		///
+		KMeansStatistics getKMeansStatistics() const { return _kMeansStatistics; }
+
 	private:
 
 		Logger* _log;
@@ -292,51 +441,218 @@ namespace hyperion
 		const int _horizontalBorder;
 		const int _verticalBorder;
 
+		/// Factor to reduce the number of pixels evaluated
+		const int _reducedPixelSetFactor;
+
 		/// Evaluate every "count" pixel
 		int _nextPixelCount;
 
 		/// Number of clusters used during dominant color advanced processing (k-means)
 		int _clusterCount;
 
-		/// The absolute indices into the image for each led
-		std::vector<std::vector<int>> _colorsMap;
+		///
+		/// The rectangular image area (row-span description) evaluated for a single LED
+		///
+		struct LedArea
+		{
+			/// Column of the top-left pixel of the area
+			int32_t x;
+			/// Row of the top-left pixel of the area
+			int32_t y;
+			/// Width of the area [pixels]
+			int32_t width;
+			/// Height of the area [pixels]
+			int32_t height;
+			/// Evaluate every "step" pixel (horizontally and vertically)
+			int32_t step;
+			/// Number of pixels evaluated for the area
+			int32_t pixelCount;
+		};
+
+		/// The led specifications the areas are computed from
+		std::vector<Led> _leds;
+
+		/// The image area for each led, stored contiguously in led order
+		std::vector<LedArea> _ledAreas;
+
+		///
+		/// Computes the image area of each LED
+		///
+		/// @param[in] leds  The list with led specifications
+		/// @param[in] base  Mapping to take over the areas of unchanged LEDs from, null to compute all areas
+		/// @param[in] accuracyLevel  The accuracy used during processing (only for selected types)
+		///
+		void buildLedAreas(const std::vector<Led>& leds, const ImageToLedsMap* base, int accuracyLevel);
+
+		///
+		/// Returns true, if both LEDs cover the same fraction of the image
+		///
+		static bool hasSameGeometry(const Led& led, const Led& other);
+
+		/// Granularity of the LED chunks processed in parallel, the chunk size is a multiple of it
+		static constexpr size_t LED_CHUNK_ALIGNMENT = 64;
+		/// Number of chunks per thread, allowing threads finishing early to take over remaining chunks
+		static constexpr size_t LED_CHUNKS_PER_THREAD = 4;
+
+		/// The worker pool processing the LEDs in parallel (optional)
+		QSharedPointer<WorkerPool> _workerPool;
+		/// Number of LEDs per chunk
+		size_t _chunkSize;
+		/// Number of chunks the LEDs are split into
+		int _chunkCount;
+
+		///
+		/// Determines the color of every LED by calling the given function for its area.
+		/// The LEDs are split into _chunkCount chunks of consecutive LEDs, which are processed in parallel using the
+		/// worker pool, if there is more than one chunk. Any state modified by the function has to be per LED or per chunk.
+		///
+		/// @param[out] ledColors  The vector containing the output
+		/// @param[in] func  The function returning the color of a LED, called with the LED area, the LED index and the chunk index
+		///
+		template <typename Func_T>
+		void processLedAreas(std::vector<ColorRgb> & ledColors, Func_T func) const
+		{
+			const auto processChunk = [&](int chunk)
+			{
+				const size_t begin = static_cast<size_t>(chunk) * _chunkSize;
+				const size_t end = qMin(begin + _chunkSize, _ledAreas.size());
+				for (size_t ledIdx = begin; ledIdx < end; ++ledIdx)
+				{
+					ledColors[ledIdx] = func(_ledAreas[ledIdx], ledIdx, chunk);
+				}
+			};
+
+			if (_chunkCount > 1)
+			{
+				_workerPool->run(_chunkCount, processChunk);
+			}
+			else
+			{
+				processChunk(0);
+			}
+		}
+
+		///
+		/// Calls the given function for every pixel of the image to be evaluated for the given area.
+		/// Rows are visited top to bottom, each row left to right.
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The area to be evaluated
+		/// @param[in] func The function called with each pixel
+		///
+		template <typename Pixel_T, typename Func_T>
+		static void forEachPixel(const Image<Pixel_T> & image, const LedArea & area, Func_T func)
+		{
+			const int imageWidth = static_cast<int>(image.width());
+			const Pixel_T* areaData = image.memptr() + area.y * imageWidth + area.x;
+
+			if (area.step == 1)
+			{
+				// Contiguous rows, let the compiler unroll/vectorize the inner loop
+				for (int y = 0; y < area.height; ++y)
+				{
+					const Pixel_T* row = areaData + y * imageWidth;
+					const Pixel_T* rowEnd = row + area.width;
+					for (const Pixel_T* pixel = row; pixel != rowEnd; ++pixel)
+					{
+						func(*pixel);
+					}
+				}
+				return;
+			}
+
+			for (int y = 0; y < area.height; y += area.step)
+			{
+				const Pixel_T* row = areaData + y * imageWidth;
+				for (int x = 0; x < area.width; x += area.step)
+				{
+					func(row[x]);
+				}
+			}
+		}
+
+		///
+		/// Accumulates the sum of each color channel (red, green, blue) over the pixels of an area
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The area to be evaluated
+		/// @param[in,out] sum The sums per color channel the area's pixels are added to
+		///
+		template <typename Pixel_T>
+		static void accumulateArea(const Image<Pixel_T> & image, const LedArea & area, uint64_t sum[3])
+		{
+			forEachPixel(image, area, [&](const Pixel_T& pixel)
+			{
+				sum[0] += pixel.red;
+				sum[1] += pixel.green;
+				sum[2] += pixel.blue;
+			});
+		}
+
+		///
+		/// Accumulates the sum of each color channel (red, green, blue) over the pixels of an area.
+		/// Contiguous rows of RGB images are summed up by a SIMD kernel (SSE2/NEON) where available.
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The area to be evaluated
+		/// @param[in,out] sum The sums per color channel the area's pixels are added to
+		///
+		static void accumulateArea(const Image<ColorRgb> & image, const LedArea & area, uint64_t sum[3]);
+
+		///
+		/// Accumulates the sum of squares of each color channel (red, green, blue) over the pixels of an area
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The area to be evaluated
+		/// @param[in,out] sum The squared sums per color channel the area's pixels are added to
+		///
+		template <typename Pixel_T>
+		static void accumulateAreaSquared(const Image<Pixel_T> & image, const LedArea & area, uint64_t sum[3])
+		{
+			forEachPixel(image, area, [&](const Pixel_T& pixel)
+			{
+				sum[0] += pixel.red * pixel.red;
+				sum[1] += pixel.green * pixel.green;
+				sum[2] += pixel.blue * pixel.blue;
+			});
+		}
+
+		///
+		/// Accumulates the sum of squares of each color channel (red, green, blue) over the pixels of an area.
+		/// Contiguous rows of RGB images are summed up by a SIMD kernel (SSE2/NEON) where available.
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The area to be evaluated
+		/// @param[in,out] sum The squared sums per color channel the area's pixels are added to
+		///
+		static void accumulateAreaSquared(const Image<ColorRgb> & image, const LedArea & area, uint64_t sum[3]);
 
 		///
 		/// Calculates the 'mean color' over the given image. This is the mean over each color-channel
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated///
+		/// @param[in] area The image area to be evaluated
 		///
-		/// @return The mean of the given list of colors (or black when empty)
+		/// @return The mean of the given area's colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColor(const Image<Pixel_T> & image, const std::vector<int32_t> & pixels) const
+		ColorRgb calcMeanColor(const Image<Pixel_T> & image, const LedArea & area) const
 		{
-			const auto pixelNum = pixels.size();
+			const auto pixelNum = static_cast<uint64_t>(area.pixelCount);
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
 			}
 
 			// Accumulate the sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const auto& imgData = image.memptr();
-			for (const int pixelOffset : pixels)
-			{
-				const auto& pixel = imgData[pixelOffset];
-				cummRed   += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue  += pixel.blue;
-			}
+			uint64_t cumm[3] {0, 0, 0};
+			accumulateArea(image, area, cumm);
 
 			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(cummRed/pixelNum);
-			const uint8_t avgGreen = uint8_t(cummGreen/pixelNum);
-			const uint8_t avgBlue  = uint8_t(cummBlue/pixelNum);
+			const uint8_t avgRed   = uint8_t(cumm[0]/pixelNum);
+			const uint8_t avgGreen = uint8_t(cumm[1]/pixelNum);
+			const uint8_t avgBlue  = uint8_t(cumm[2]/pixelNum);
 
 			// Return the computed color
 			return {avgRed, avgGreen, avgBlue};
@@ -353,29 +669,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calcMeanColor(const Image<Pixel_T> & image) const
 		{
-			// Accumulate the sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const unsigned pixelNum = image.width() * image.height();
-			const auto& imgData = image.memptr();
-
-			for (unsigned idx=0; idx<pixelNum; idx++)
-			{
-				const auto& pixel = imgData[idx];
-				cummRed   += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue  += pixel.blue;
-			}
-
-			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(cummRed/pixelNum);
-			const uint8_t avgGreen = uint8_t(cummGreen/pixelNum);
-			const uint8_t avgBlue  = uint8_t(cummBlue/pixelNum);
-
-			// Return the computed color
-			return {avgRed, avgGreen, avgBlue};
+			return calcMeanColor(image, wholeImageArea(image));
 		}
 
 		///
@@ -383,39 +677,27 @@ namespace hyperion
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
 		///
-		/// @return The mean of the given list of colors (or black when empty)
+		/// @return The mean of the given area's colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image, const std::vector<int32_t> & pixels) const
+		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image, const LedArea & area) const
 		{
-			const auto pixelNum = pixels.size();
+			const auto pixelNum = static_cast<uint64_t>(area.pixelCount);
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
 			}
 
 			// Accumulate the squared sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const auto& imgData = image.memptr();
-
-			for (const int colorOffset : pixels)
-			{
-				const auto& pixel = imgData[colorOffset];
-
-				cummRed   += pixel.red * pixel.red;
-				cummGreen += pixel.green * pixel.green;
-				cummBlue  += pixel.blue * pixel.blue;
-			}
+			uint64_t cumm[3] {0, 0, 0};
+			accumulateAreaSquared(image, area, cumm);
 
 			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cummRed/pixelNum))), 255L));
-			const uint8_t avgGreen = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cummGreen/pixelNum))), 255L));
-			const uint8_t avgBlue  = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cummBlue/pixelNum))), 255L));
+			const uint8_t avgRed   = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cumm[0]/pixelNum))), 255L));
+			const uint8_t avgGreen = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cumm[1]/pixelNum))), 255L));
+			const uint8_t avgBlue  = uint8_t(std::min(std::lround(sqrt(static_cast<double>(cumm[2]/pixelNum))), 255L));
 
 			// Return the computed color
 			return {avgRed, avgGreen, avgBlue};
@@ -432,66 +714,226 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image) const
 		{
-			// Accumulate the squared sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
+			return calcMeanColorSqrt(image, wholeImageArea(image));
+		}
+
+		/// Maximum number of image pixels for which the sums of any area fit into the 32 bit integral image
+		static constexpr uint64_t MAX_INTEGRAL_IMAGE_PIXELS = UINT32_MAX / 255;
+
+		/// Summed-area table of the last image (allocated on first use unless set)
+		mutable QSharedPointer<IntegralImage> _integralImage;
+
+		///
+		/// Builds the summed-area table (integral image) of the given image in a single pass.
+		/// Entry (x,y) holds the channel sums of all pixels left of x and above y, the first row and
+		/// column are zero. Sums wrap around modulo 2^32, which keeps the sums of areas exact,
+		/// as long as an area's true sum fits into 32 bits.
+		///
+		/// @param[in] image The image to be summed up
+		///
+		template <typename Pixel_T>
+		void buildIntegralImage(const Image<Pixel_T> & image) const
+		{
+			const int width = static_cast<int>(image.width());
+			const int height = static_cast<int>(image.height());
+
+			if (_integralImage.isNull())
+			{
+				_integralImage = QSharedPointer<IntegralImage>::create();
+			}
 
-			const unsigned pixelNum = image.width() * image.height();
-			const auto& imgData = image.memptr();
+			std::vector<uint32_t>& sums = _integralImage->sums;
+			const size_t stride = static_cast<size_t>(width + 1) * 3;
+			_integralImage->stride = stride;
+			sums.resize(stride * static_cast<size_t>(height + 1));
+			std::fill(sums.begin(), sums.begin() + static_cast<std::ptrdiff_t>(stride), 0);
 
-			for (int idx=0; idx<pixelNum; ++idx)
+			const Pixel_T* pixel = image.memptr();
+			for (int y = 0; y < height; ++y)
 			{
-				const auto& pixel = imgData[idx];
-				cummRed   += pixel.red * pixel.red;
-				cummGreen += pixel.green * pixel.green;
-				cummBlue  += pixel.blue * pixel.blue;
+				const uint32_t* above = sums.data() + static_cast<size_t>(y) * stride;
+				uint32_t* current = sums.data() + static_cast<size_t>(y + 1) * stride;
+
+				current[0] = current[1] = current[2] = 0;
+
+				uint32_t rowRed = 0, rowGreen = 0, rowBlue = 0;
+				for (int x = 3; x <= width * 3; x += 3, ++pixel)
+				{
+					rowRed   += pixel->red;
+					rowGreen += pixel->green;
+					rowBlue  += pixel->blue;
+
+					current[x]   = above[x]   + rowRed;
+					current[x+1] = above[x+1] + rowGreen;
+					current[x+2] = above[x+2] + rowBlue;
+				}
 			}
+		}
 
-			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(std::lround(sqrt(static_cast<double>(cummRed/pixelNum))));
-			const uint8_t avgGreen = uint8_t(std::lround(sqrt(static_cast<double>(cummGreen/pixelNum))));
-			const uint8_t avgBlue  = uint8_t(std::lround(sqrt(static_cast<double>(cummBlue/pixelNum))));
+		///
+		/// Calculates the 'mean color' of an image area using the summed-area table of the image.
+		///
+		/// @param[in] area The image area to be evaluated
+		///
+		/// @return The mean of the given area's colors (or black when empty)
+		///
+		ColorRgb calcMeanColorIntegral(const LedArea & area) const
+		{
+			const uint32_t pixelNum = static_cast<uint32_t>(area.width * area.height);
+			if (pixelNum == 0)
+			{
+				return ColorRgb::BLACK;
+			}
 
-			// Return the computed color
-			return {avgRed, avgGreen, avgBlue};
+			const uint32_t* sums = _integralImage->sums.data();
+			const size_t stride = _integralImage->stride;
+			const uint32_t* top = sums + static_cast<size_t>(area.y) * stride;
+			const uint32_t* bottom = sums + static_cast<size_t>(area.y + area.height) * stride;
+			const size_t left = static_cast<size_t>(area.x) * 3;
+			const size_t right = static_cast<size_t>(area.x + area.width) * 3;
+
+			uint8_t avg[3];
+			for (size_t channel = 0; channel < 3; ++channel)
+			{
+				const uint32_t sum = bottom[right + channel] - bottom[left + channel] - top[right + channel] + top[left + channel];
+				avg[channel] = uint8_t(sum / pixelNum);
+			}
+
+			return {avg[0], avg[1], avg[2]};
+		}
+
+		/// Number of bins of the quantized color histogram (4 bits per color channel)
+		static constexpr int HISTOGRAM_BINS = 4096;
+
+		///
+		/// Histogram of 12 bit colors used for dominant color processing. It is reused across LEDs,
+		/// after an evaluation only the bins used are cleared again.
+		///
+		struct ColorHistogram
+		{
+			ColorHistogram() : counts(HISTOGRAM_BINS, 0)
+			{
+				usedBins.reserve(HISTOGRAM_BINS);
+			}
+
+			///
+			/// Counts a color
+			///
+			/// @param[in] bin The color's bin
+			///
+			/// @return The number of colors in the bin
+			///
+			uint32_t add(int bin)
+			{
+				const uint32_t count = ++counts[bin];
+				if (count == 1)
+				{
+					usedBins.push_back(static_cast<uint16_t>(bin));
+				}
+				return count;
+			}
+
+			/// Resets all bins used to zero
+			void clear()
+			{
+				for (const uint16_t bin : usedBins)
+				{
+					counts[bin] = 0;
+				}
+				usedBins.clear();
+			}
+
+			std::vector<uint32_t> counts;
+			std::vector<uint16_t> usedBins;
+		};
+
+		/// Histograms used for dominant color processing, one per chunk of LEDs
+		mutable std::vector<ColorHistogram> _histograms;
+
+		/// Refine the dominant color to the most frequent full resolution color of the dominant bin
+		bool _dominantColorRefinement;
+
+		///
+		/// Returns the histogram bin of a color, using the upper 4 bits of each color channel
+		///
+		static int histogramBin(uint8_t red, uint8_t green, uint8_t blue)
+		{
+			return ((red >> 4) << 8) | ((green >> 4) << 4) | (blue >> 4);
 		}
 
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		/// Returns the histogram bin of a color within its quantized bin, using the lower 4 bits of each color channel
+		///
+		static int histogramSubBin(uint8_t red, uint8_t green, uint8_t blue)
+		{
+			return ((red & 0x0F) << 8) | ((green & 0x0F) << 4) | (blue & 0x0F);
+		}
+
+		///
+		/// Calculates the 'dominant color' of an image area.
+		/// The area's colors are counted in a histogram of 12 bit colors, the most frequent bin is the dominant one.
+		/// A second pass over the pixels of that bin determines the resulting color, either the most frequent
+		/// full resolution color (refinement enabled) or the mean color of the bin.
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in] histogram The histogram used for counting, all bins are zero before and after the evaluation
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColor(const Image<Pixel_T> & image, const std::vector<int> & pixels) const
+		ColorRgb calculateDominantColor(const Image<Pixel_T> & image, const LedArea & area, ColorHistogram & histogram) const
 		{
 			ColorRgb dominantColor {ColorRgb::BLACK};
 
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			if (area.pixelCount > 0)
 			{
-				const auto& imgData = image.memptr();
-
-				QMap<QRgb,int> colorDistributionMap;
-				int count = 0;
-				for (const int pixelOffset : pixels)
+				uint32_t dominantCount = 0;
+				int dominantBin = 0;
+				forEachPixel(image, area, [&](const Pixel_T& pixel)
 				{
-					QRgb color = imgData[pixelOffset].rgb();
-					if (colorDistributionMap.contains(color)) {
-						colorDistributionMap[color] = colorDistributionMap[color] + 1;
-					}
-					else  {
-						colorDistributionMap[color] = 1;
+					const int bin = histogramBin(pixel.red, pixel.green, pixel.blue);
+					const uint32_t count = histogram.add(bin);
+					if (count > dominantCount)
+					{
+						dominantCount = count;
+						dominantBin = bin;
 					}
+				});
+				histogram.clear();
 
-					int colorsFound  =  colorDistributionMap[color];
-					if (colorsFound > count)  {
-						dominantColor.setRgb(color);
-						count = colorsFound;
-					}
+				if (_dominantColorRefinement)
+				{
+					// Most frequent full resolution color within the dominant bin
+					uint32_t colorsFoundMax = 0;
+					forEachPixel(image, area, [&](const Pixel_T& pixel)
+					{
+						if (histogramBin(pixel.red, pixel.green, pixel.blue) == dominantBin)
+						{
+							const uint32_t colorsFound = histogram.add(histogramSubBin(pixel.red, pixel.green, pixel.blue));
+							if (colorsFound > colorsFoundMax)
+							{
+								colorsFoundMax = colorsFound;
+								dominantColor = ColorRgb(pixel.red, pixel.green, pixel.blue);
+							}
+						}
+					});
+					histogram.clear();
+				}
+				else
+				{
+					// Mean color of the dominant bin
+					uint64_t cumm[3] {0, 0, 0};
+					forEachPixel(image, area, [&](const Pixel_T& pixel)
+					{
+						if (histogramBin(pixel.red, pixel.green, pixel.blue) == dominantBin)
+						{
+							cumm[0] += pixel.red;
+							cumm[1] += pixel.green;
+							cumm[2] += pixel.blue;
+						}
+					});
+					dominantColor = ColorRgb(uint8_t(cumm[0] / dominantCount), uint8_t(cumm[1] / dominantCount), uint8_t(cumm[2] / dominantCount));
 				}
 			}
 			return dominantColor;
@@ -507,26 +949,33 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calculateDominantColor(const Image<Pixel_T> & image) const
 		{
-			const unsigned pixelNum = image.width() * image.height();
-
-			std::vector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
-
-			return calculateDominantColor(image, pixels);
+			ColorHistogram histogram;
+			return calculateDominantColor(image, wholeImageArea(image), histogram);
 		}
 
+		///
+		/// Returns an area covering the given image completely
+		///
+		/// @param[in] image The image to be covered
+		///
+		/// @return The area covering every pixel of the image
+		///
 		template <typename Pixel_T>
-		struct ColorCluster {
+		static LedArea wholeImageArea(const Image<Pixel_T> & image)
+		{
+			const int32_t width = static_cast<int32_t>(image.width());
+			const int32_t height = static_cast<int32_t>(image.height());
+			return {0, 0, width, height, 1, width * height};
+		}
 
-			ColorCluster():count(0) {}
-			ColorCluster(Pixel_T color):count(0),color(color) {}
+		/// Maximum number of clusters (accuracy level 4)
+		static constexpr int MAX_CLUSTER_COUNT = 5;
+		/// Maximum number of k-means iterations per LED and frame
+		static constexpr int KMEANS_MAX_ITERATIONS = 10;
+		/// Number of frames after which the k-means statistics are logged
+		static constexpr uint64_t KMEANS_STATISTICS_INTERVAL = 1000;
 
-			Pixel_T color;
-			Pixel_T newColor;
-			int count;
-		};
-
-		const ColorRgb DEFAULT_CLUSTER_COLORS[5] {
+		const ColorRgb DEFAULT_CLUSTER_COLORS[MAX_CLUSTER_COUNT] {
 			{ColorRgb::BLACK},
 			{ColorRgb::GREEN},
 			{ColorRgb::WHITE},
@@ -534,107 +983,111 @@ namespace hyperion
 			{ColorRgb::YELLOW}
 		};
 
+		/// The cluster colors per LED (MAX_CLUSTER_COUNT entries each) of the last frame, used as seed for the next one
+		mutable std::vector<ColorRgb> _clusterColors;
+
+		/// Statistics of the k-means processing
+		mutable KMeansStatistics _kMeansStatistics;
+
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
-		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
+		/// Resets the cluster colors of all LEDs to the default cluster colors
+		///
+		void resetClusterColors();
+
+		///
+		/// Calculates the 'dominant color' of an image area
+		/// using a k-means algorithm (https://robocraft.ru/computervision/1063).
+		/// The clustering starts from the given cluster colors, which are updated with the resulting ones.
+		/// It stops as soon as the cluster colors do not change anymore or after KMEANS_MAX_ITERATIONS iterations.
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in,out] clusterColors The initial cluster colors (_clusterCount entries), updated to the resulting ones
+		/// @param[in,out] statistics The statistics to be updated
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image, const std::vector<int> & pixels) const
+		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image, const LedArea & area, ColorRgb* clusterColors, KMeansStatistics & statistics) const
 		{
 			ColorRgb dominantColor {ColorRgb::BLACK};
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			if (area.pixelCount > 0)
 			{
-				// initial cluster with different colors
-				auto clusters = std::unique_ptr< ColorCluster<ColorRgbScalar> >(new ColorCluster<ColorRgbScalar>[_clusterCount]);
-				for(int k = 0; k < _clusterCount; ++k)
-				{
-					clusters.get()[k].newColor = DEFAULT_CLUSTER_COLORS[k];
-				}
+				uint32_t counts[MAX_CLUSTER_COUNT];
+				uint64_t sums[MAX_CLUSTER_COUNT][3];
 
-				// k-means
-				double min_rgb_euclidean {0};
-				double old_rgb_euclidean {0};
-
-				while(1)
+				int iteration = 0;
+				bool changed = true;
+				while (changed && iteration < KMEANS_MAX_ITERATIONS)
 				{
-					for(int k = 0; k < _clusterCount; ++k)
-					{
-						clusters.get()[k].count = 0;
-						clusters.get()[k].color = clusters.get()[k].newColor;
-						clusters.get()[k].newColor.setRgb(ColorRgb::BLACK);
-					}
+					++iteration;
 
-					const auto& imgData = image.memptr();
-					for (const int pixelOffset : pixels)
-					{
-						const auto& pixel = imgData[pixelOffset];
+					std::fill(counts, counts + _clusterCount, 0);
+					std::fill(&sums[0][0], &sums[0][0] + _clusterCount * 3, 0);
 
-						min_rgb_euclidean = 255 * 255 * 255;
-						int clusterIndex = -1;
-						for(int k = 0; k < _clusterCount; ++k)
+					// Assign each pixel to the cluster with the nearest color
+					forEachPixel(image, area, [&](const Pixel_T& pixel)
+					{
+						int minDistance = INT_MAX;
+						int clusterIndex = 0;
+						for (int k = 0; k < _clusterCount; ++k)
 						{
-							double euclid = ColorSys::rgb_euclidean(ColorRgbScalar(pixel), clusters.get()[k].color);
+							const int dRed = pixel.red - clusterColors[k].red;
+							const int dGreen = pixel.green - clusterColors[k].green;
+							const int dBlue = pixel.blue - clusterColors[k].blue;
+							const int distance = dRed * dRed + dGreen * dGreen + dBlue * dBlue;
 
-							if(  euclid < min_rgb_euclidean ) {
-								min_rgb_euclidean = euclid;
+							if (distance < minDistance)
+							{
+								minDistance = distance;
 								clusterIndex = k;
 							}
 						}
 
-						clusters.get()[clusterIndex].count++;
-						clusters.get()[clusterIndex].newColor += ColorRgbScalar(pixel);
-					}
+						counts[clusterIndex]++;
+						sums[clusterIndex][0] += pixel.red;
+						sums[clusterIndex][1] += pixel.green;
+						sums[clusterIndex][2] += pixel.blue;
+					});
 
-					min_rgb_euclidean = 0;
-					for(int k = 0; k < _clusterCount; ++k)
+					// Move each cluster to the mean color of its pixels, empty clusters keep their color
+					changed = false;
+					for (int k = 0; k < _clusterCount; ++k)
 					{
-						if (clusters.get()[k].count > 0)
+						if (counts[k] > 0)
 						{
-							// new color
-							clusters.get()[k].newColor /= clusters.get()[k].count;
-							double ecli = ColorSys::rgb_euclidean(clusters.get()[k].newColor, clusters.get()[k].color);
-							if(ecli > min_rgb_euclidean)
+							const ColorRgb newColor(uint8_t(sums[k][0] / counts[k]), uint8_t(sums[k][1] / counts[k]), uint8_t(sums[k][2] / counts[k]));
+							if (newColor.red != clusterColors[k].red || newColor.green != clusterColors[k].green || newColor.blue != clusterColors[k].blue)
 							{
-								min_rgb_euclidean = ecli;
+								clusterColors[k] = newColor;
+								changed = true;
 							}
 						}
 					}
-
-					if( fabs(min_rgb_euclidean - old_rgb_euclidean) < 1)
-					{
-						break;
-					}
-
-					old_rgb_euclidean = min_rgb_euclidean;
 				}
 
-				int colorsFoundMax = 0;
+				statistics.clusterings++;
+				statistics.iterations += static_cast<uint64_t>(iteration);
+
+				uint32_t colorsFoundMax = 0;
 				int dominantClusterIdx {0};
 
 				for(int clusterIdx=0; clusterIdx < _clusterCount; ++clusterIdx){
-					int colorsFoundinCluster = clusters.get()[clusterIdx].count;
+					const uint32_t colorsFoundinCluster = counts[clusterIdx];
 					if (colorsFoundinCluster > colorsFoundMax)  {
 						colorsFoundMax = colorsFoundinCluster;
 						dominantClusterIdx = clusterIdx;
 					}
 				}
 
-				dominantColor.red = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.red);
-				dominantColor.green = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.green);
-				dominantColor.blue = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.blue);
+				dominantColor = clusterColors[dominantClusterIdx];
 			}
 
 			return dominantColor;
 		}
 
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		/// Calculates the 'dominant color' of an image
 		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
@@ -644,12 +1097,11 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image) const
 		{
-			const unsigned pixelNum = image.width() * image.height();
-
-			std::vector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
+			ColorRgb clusterColors[MAX_CLUSTER_COUNT];
+			std::copy(DEFAULT_CLUSTER_COLORS, DEFAULT_CLUSTER_COLORS + MAX_CLUSTER_COUNT, clusterColors);
 
-			return calculateDominantColorAdv(image, pixels);
+			KMeansStatistics statistics;
+			return calculateDominantColorAdv(image, wholeImageArea(image), clusterColors, statistics);
 		}
 	};
 
@@ -0,0 +1,106 @@
+#pragma once
+
+// STL includes
+#include <vector>
+
+// QT includes
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+
+// Hyperion includes
+#include <hyperion/ImageToLedsMap.h>
+#include <hyperion/LedString.h>
+
+class QThread;
+
+///
+/// Builds updated image to LEDs mappings or mappings for other image geometries in the background, living on its own thread.
+/// Only the latest request is processed, requests superseded before their build started are dropped.
+///
+class ImageToLedsMapBuilder : public QObject
+{
+	Q_OBJECT
+
+public:
+	ImageToLedsMapBuilder();
+
+	///
+	/// Requests a mapping for an updated list of LEDs based on the given mapping (thread safe).
+	/// A pending request is replaced. Once built, mapBuilt() is emitted.
+	///
+	/// @param[in] base                   The mapping to take over the image geometry and unchanged areas from
+	/// @param[in] leds                   The updated list with led specifications
+	/// @param[in] reducedPixelSetFactor  Factor to reduce the number of pixels evaluated during processing
+	/// @param[in] accuracyLevel          The accuracy used during processing (only for selected types)
+	/// @param[in] generation             Identifies the request, returned with the mapping built
+	/// @param[in] targetThread           The thread the mapping built is moved to
+	///
+	void requestMap(const QSharedPointer<hyperion::ImageToLedsMap>& base, const std::vector<Led>& leds,
+					int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread);
+
+	///
+	/// Requests a mapping for the given image geometry (thread safe).
+	/// A pending request is replaced. Once built, mapBuilt() is emitted.
+	///
+	/// @param[in] log                    Logger of the mapping
+	/// @param[in] width                  The width of the indexed image
+	/// @param[in] height                 The height of the indexed image
+	/// @param[in] horizontalBorder       The size of the horizontal border (0=no border)
+	/// @param[in] verticalBorder         The size of the vertical border (0=no border)
+	/// @param[in] leds                   The list with led specifications
+	/// @param[in] reducedPixelSetFactor  Factor to reduce the number of pixels evaluated during processing
+	/// @param[in] accuracyLevel          The accuracy used during processing (only for selected types)
+	/// @param[in] generation             Identifies the request, returned with the mapping built
+	/// @param[in] targetThread           The thread the mapping built is moved to
+	///
+	void requestMap(Logger* log, int width, int height, int horizontalBorder, int verticalBorder, const std::vector<Led>& leds,
+					int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread);
+
+	///
+	/// Takes the mapping built last (thread safe)
+	///
+	/// @param[out] generation  The generation of the request the mapping was built for
+	///
+	/// @return The mapping or null, if there is none
+	///
+	QSharedPointer<hyperion::ImageToLedsMap> takeMap(quint64& generation);
+
+signals:
+	///
+	/// Emitted when a mapping was built
+	///
+	void mapBuilt();
+
+private slots:
+	///
+	/// Builds the mapping of the pending request
+	///
+	void build();
+
+private:
+	///
+	/// Stores a request and schedules its build, called with the mutex locked
+	///
+	void scheduleBuild(const std::vector<Led>& leds, int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread);
+
+	/// Protects the members below
+	QMutex _mutex;
+
+	bool _requestPending;
+	/// The mapping to update or null, if a mapping for the geometry below is requested
+	QSharedPointer<hyperion::ImageToLedsMap> _base;
+	Logger* _log;
+	int _width;
+	int _height;
+	int _horizontalBorder;
+	int _verticalBorder;
+	std::vector<Led> _leds;
+	int _reducedPixelSetFactor;
+	int _accuracyLevel;
+	quint64 _requestGeneration;
+	QThread* _targetThread;
+
+	QSharedPointer<hyperion::ImageToLedsMap> _map;
+	quint64 _mapGeneration;
+};
@@ -4,6 +4,7 @@
 // STL includes
 #include <vector>
 #include <deque>
+#include <utility>
 
 // Qt includes
 #include <QVector>
@@ -86,9 +87,10 @@ public:
 	/// LED values as input for the smoothing filter
 	///
 	/// @param ledValues The color-value per led
+	/// @param metadata The metadata of the image the values are derived from (capture time, sequence number, source)
 	/// @return Zero on success else negative
 	///
-	virtual int updateLedValues(const std::vector<ColorRgb> &ledValues);
+	virtual int updateLedValues(const std::vector<ColorRgb> &ledValues, const ImageMetadata &metadata = ImageMetadata());
 
 	void setEnable(bool enable);
 	void setPause(bool pause);
@@ -158,9 +160,10 @@ private:
 	/// write updated values as input for the smoothing filter
 	///
 	/// @param ledValues The color-value per led
+	/// @param metadata The metadata of the image the values are derived from
 	/// @return Zero on success else negative
 	///
-	virtual int write(const std::vector<ColorRgb> &ledValues);
+	virtual int write(const std::vector<ColorRgb> &ledValues, const ImageMetadata &metadata);
 
 	QString getConfig(int cfgID);
 
@@ -188,6 +191,9 @@ private:
 	/// The target led data
 	std::vector<ColorRgb> _targetValues;
 
+	/// The metadata of the target led data. The capture time is reset, once the first frame approaching it is queued.
+	ImageMetadata _targetMetadata;
+
 	/// The timestamp of the previously written led data
 	int64_t _previousWriteTime;
 
@@ -200,8 +206,8 @@ private:
 	/// The number of updates to keep in the output queue (delayed) before being output
 	unsigned _outputDelay;
 
-	/// The output queue
-	std::deque<std::vector<ColorRgb>> _outputQueue;
+	/// The output queue, with the capture time of the target led data per frame (0, if it was queued before)
+	std::deque<std::pair<std::vector<ColorRgb>, qint64>> _outputQueue;
 
 	/// A frame of led colors used for temporal smoothing
 	class REMEMBERED_FRAME
@@ -5,6 +5,7 @@
 #include <cstdint>
 
 // QT includes
+#include <QSharedPointer>
 #include <QMap>
 #include <QObject>
 #include <QMap>
@@ -13,6 +14,8 @@
 // Utils includes
 #include <utils/ColorRgb.h>
 #include <utils/Image.h>
+#include <utils/ImageMetadata.h>
+#include <utils/LatestValueSlotTable.h>
 #include <utils/Components.h>
 
 // global defines
@@ -44,6 +47,12 @@ public:
 		std::vector<ColorRgb> ledColors;
 		/// The raw Image (size should be preprocessed!)
 		Image<ColorRgb> image;
+		/// The metadata of the image (capture time, sequence number, source), reset when colors are set
+		ImageMetadata metadata;
+		/// The number of frames numbered by the image source, which did not reach the input since it was registered.
+		/// Detected by gaps of the sequence numbers, they are frames dropped by the grabber or its decoder,
+		/// replaced in the image slot by a newer frame or throttled while the input was hidden.
+		quint64 skippedFrames = 0;
 		/// The component
 		hyperion::Components componentId;
 		/// Who set it
@@ -56,6 +65,22 @@ public:
 
 	typedef QMap<int, InputInfo> InputsMap;
 
+	///
+	/// An image published to the slot of a priority channel by its producer
+	///
+	struct InputImage
+	{
+		/// The image
+		Image<ColorRgb> image;
+		/// The timeout of the channel
+		int64_t timeout_ms;
+		/// Clear a running effect of the channel
+		bool clearEffect;
+	};
+
+	/// The image slots handing over the latest image of the priority channels from their producer's thread, indexed by priority
+	using ImageSlotTable = LatestValueSlotTable<InputImage>;
+
 	//Foreground and Background priorities
 	const static int FG_PRIORITY;
 	const static int BG_PRIORITY;
@@ -149,7 +174,7 @@ public:
 	///
 	/// @return The information for the specified priority channel
 	///
-	InputInfo getInputInfo(int priority) const;
+	const InputInfo& getInputInfo(int priority) const;
 
 	///
 	/// @brief  Register a new input by priority, the priority is not active (timeout -100 isn't muxer recognized) until you start to update the data with setInput()
@@ -187,6 +212,12 @@ public:
 	///
 	bool setInputInactive(int priority);
 
+	///
+	/// @brief  Get the table of the image slots (thread safe). It is shared with the producers, which publish to it from
+	///         their own thread and may outlive the muxer.
+	///
+	QSharedPointer<ImageSlotTable> getImageSlotTable() const;
+
 	///
 	/// Clears the specified priority channel and update _currentPriority on success
 	///
@@ -266,6 +297,9 @@ private:
 	/// The mapping from priority channel to led-information
 	InputsMap _activeInputs;
 
+	/// The image slots indexed by priority, created on first registration and never removed
+	QSharedPointer<ImageSlotTable> _imageSlots;
+
 	/// The information of the lowest priority channel
 	InputInfo _lowestPriorityInfo;
 
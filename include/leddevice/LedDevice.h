@@ -201,12 +201,14 @@ public slots:
 	///
 	/// @brief Update the color values of the device's LEDs.
 	///
-	/// Handles refreshing of LEDs.
+	/// Handles refreshing of LEDs. The latency from capturing the image the colors are derived from to writing them
+	/// is recorded by the LatencyStatistics.
 	///
 	/// @param[in] ledValues The color per LED
+	/// @param[in] captureTime The capture time of the image the colors are derived from, 0 if unknown (see Image::captureTime())
 	/// @return Zero on success else negative (i.e. device is not ready)
 	///
-	virtual int updateLeds(std::vector<ColorRgb> ledValues);
+	virtual int updateLeds(std::vector<ColorRgb> ledValues, qint64 captureTime = 0);
 
 	///
 	/// @brief Get the currently defined LatchTime.
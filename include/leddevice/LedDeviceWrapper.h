@@ -88,11 +88,12 @@ signals:
 	///
 	/// PIPER signal for Hyperion -> LedDevice
 	///
-	/// @param[in] ledValues  The RGB-color per led
+	/// @param[in] ledValues    The RGB-color per led
+	/// @param[in] captureTime  The capture time of the image the colors are derived from or 0
 	///
 	/// @return Zero on success else negative
 	///
-	int updateLeds(const std::vector<ColorRgb>& ledValues);
+	int updateLeds(const std::vector<ColorRgb>& ledValues, qint64 captureTime);
 
 	///
 	/// @brief Switch the LEDs on.
@@ -0,0 +1,99 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// QT includes
+#include <QMutex>
+#include <QtGlobal>
+
+///
+/// Process wide pool of aligned pixel buffers used by ImageData.
+/// Released buffers are kept per size and handed out again, so images of a constant size do not allocate
+/// memory on the heap once the pool is warmed up. The pool is thread safe.
+///
+class FrameBufferPool
+{
+public:
+	/// Alignment of the buffers [bytes], suitable for SIMD loads and a multiple of the cache line size
+	static constexpr size_t ALIGNMENT = 64;
+	/// Maximum number of free buffers kept per buffer size
+	static constexpr size_t MAX_FREE_BUFFERS_PER_SIZE = 8;
+	/// Maximum number of bytes kept in free buffers in total
+	static constexpr size_t MAX_FREE_BYTES = 64 * 1024 * 1024;
+
+	///
+	/// Pool statistics since start
+	///
+	struct Statistics
+	{
+		/// Buffers requested
+		quint64 acquired;
+		/// Buffers requested and served from the pool
+		quint64 reused;
+		/// Buffers released
+		quint64 released;
+		/// Released buffers freed, as the pool was full
+		quint64 discarded;
+		/// Free buffers currently kept
+		quint64 freeBuffers;
+		/// Bytes currently kept in free buffers
+		quint64 freeBytes;
+		/// Buffers filled as a deep copy of another image
+		quint64 copies;
+
+		double reuseRate() const { return acquired > 0 ? static_cast<double>(reused) / acquired : 0.0; }
+	};
+
+	///
+	/// Returns the process wide pool
+	///
+	static FrameBufferPool& getInstance();
+
+	///
+	/// Returns a buffer of at least the given size, aligned to ALIGNMENT
+	///
+	/// @param[in] size  The requested size [bytes]
+	///
+	/// @return The buffer, to be returned by release() with the same size
+	///
+	void* acquire(size_t size);
+
+	///
+	/// Returns a buffer acquired before to the pool
+	///
+	/// @param[in] buffer  The buffer (null is ignored)
+	/// @param[in] size    The size the buffer was acquired with [bytes]
+	///
+	void release(void* buffer, size_t size);
+
+	///
+	/// Counts a buffer filled as a deep copy of another image's buffer
+	///
+	void countCopy();
+
+	///
+	/// Frees all buffers kept by the pool
+	///
+	void clear();
+
+	///
+	/// Returns the pool statistics
+	///
+	Statistics statistics() const;
+
+private:
+	FrameBufferPool();
+
+	/// Returns the size of the buffers serving the given size
+	static size_t bufferSize(size_t size);
+
+	mutable QMutex _mutex;
+
+	/// Free buffers by buffer size
+	std::unordered_map<size_t, std::vector<void*>> _freeBuffers;
+
+	Statistics _statistics;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+// QT includes
+#include <QMutex>
+#include <QtGlobal>
+
+///
+/// Process wide statistics of the video grabbers' decoding threads, i.e. how many frames were decoded,
+/// dropped or delivered out of order. The statistics are thread safe.
+///
+class FrameDecoderStatistics
+{
+public:
+	/// Number of MJPEG scale factors tracked, 1/1, 1/2, 1/4 and 1/8
+	static constexpr int MJPEG_SCALES = 4;
+
+	///
+	/// Decoding time of MJPEG frames at one scale factor
+	///
+	struct ScaleStatistics
+	{
+		/// Frames decoded
+		quint64 frames;
+		/// Total decoding time [ns]
+		quint64 nsecs;
+
+		double averageMs() const { return frames > 0 ? static_cast<double>(nsecs) / frames / 1000000.0 : 0.0; }
+	};
+
+	///
+	/// Decoding statistics since start
+	///
+	struct Statistics
+	{
+		/// Decoding threads of the active grabber
+		quint32 threads;
+		/// Frames decoded
+		quint64 decoded;
+		/// Frames which could not be decoded
+		quint64 failed;
+		/// Frames dropped, as all threads were busy or a later frame was delivered before
+		quint64 dropped;
+		/// Frames decoded before an earlier frame, i.e. held back to be delivered in order or dropped
+		quint64 reordered;
+		/// MJPEG decoding by scale factor, index i for 1/2^i
+		ScaleStatistics mjpeg[MJPEG_SCALES];
+	};
+
+	///
+	/// Returns the process wide statistics
+	///
+	static FrameDecoderStatistics& getInstance();
+
+	void setThreads(quint32 threads);
+	void countDecoded(bool success);
+	void countDropped();
+	void countReordered();
+
+	///
+	/// Counts an MJPEG frame decoded at the given scale
+	///
+	/// @param[in] scaleDenominator  The denominator of the scale factor 1/1, 1/2, 1/4 or 1/8
+	/// @param[in] nsecs             The decoding time [ns]
+	///
+	void countMjpegDecoded(int scaleDenominator, qint64 nsecs);
+
+	///
+	/// Returns the statistics
+	///
+	Statistics statistics() const;
+
+private:
+	FrameDecoderStatistics();
+
+	mutable QMutex _mutex;
+
+	Statistics _statistics;
+};
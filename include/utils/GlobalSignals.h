@@ -10,6 +10,9 @@
 
 ///
 /// Singleton instance for simple signal sharing across threads, should be never used with Qt:DirectConnection!
+/// Exception: the image and clear signals may be connected directly to a functor, which only publishes or posts a clear
+/// to a shared LatestValueSlotTable captured by value. It must not touch its context object, as the sending thread may call it
+/// while the context object is destroyed; the receiver closes the table before (see LatestValueSlotTable).
 ///
 class GlobalSignals : public QObject
 {
@@ -117,4 +120,19 @@ signals:
 	///
 	void requestSource(hyperion::Components component, int hyperionInd, bool listen);
 
+	///
+	/// @brief Tell v4l2/screen/audio capture, if its images are visible or hidden behind a higher priority
+	/// @param component  The component to handle
+	/// @param hyperionInd The Hyperion instance index as identifier
+	/// @param visible  True when visible, else false
+	///
+	void requestSourceVisibility(hyperion::Components component, int hyperionInd, bool visible);
+
+	///
+	/// @brief Tell the global inputs the visible priority of an instance, so hidden inputs can throttle
+	/// @param hyperionInd The Hyperion instance index as identifier
+	/// @param priority    The visible priority, -1 when the instance stopped
+	///
+	void visiblePriorityChanged(int hyperionInd, int priority);
+
 };
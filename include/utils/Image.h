@@ -42,7 +42,7 @@ public:
 		_d_ptr = other._d_ptr;
 	}
 
-	Image& operator=(Image rhs)
+	Image& operator=(const Image& rhs)
 	{
 		// Define assignment operator in terms of the copy constructor
 		// More to read: https://stackoverflow.com/questions/255612/dynamically-allocating-an-array-of-objects?answertab=active#tab-top
@@ -142,6 +142,66 @@ public:
 		_d_ptr->resize(width, height);
 	}
 
+	///
+	/// Prepares the image to be overwritten completely with the given size.
+	/// If the image data is shared with other images (e.g. a frame handed over before), new data is used
+	/// instead of detaching, which would copy all pixels just to overwrite them. The pixels are undefined afterwards.
+	///
+	/// @param width The width of the image
+	/// @param height The height of the image
+	///
+	void reset(unsigned width, unsigned height)
+	{
+		if (_d_ptr.constData()->ref > 1)
+		{
+			_d_ptr = QSharedDataPointer<ImageData<Pixel_T>>(new ImageData<Pixel_T>(width, height));
+		}
+		else
+		{
+			_d_ptr->resize(width, height);
+		}
+	}
+
+	///
+	/// Returns the time the image was captured, e.g. the timestamp of the capture device's buffer
+	///
+	/// @return The capture time on the clock of LatencyStatistics::now() [ns], 0 if unknown
+	///
+	qint64 captureTime() const
+	{
+		return _d_ptr->metadata().captureTime;
+	}
+
+	///
+	/// Sets the time the image was captured. Set it before the image is handed over,
+	/// as the pixels are copied, if the image data is shared.
+	///
+	/// @param captureTime The capture time on the clock of LatencyStatistics::now() [ns]
+	///
+	void setCaptureTime(qint64 captureTime)
+	{
+		_d_ptr->metadata().captureTime = captureTime;
+	}
+
+	///
+	/// Returns the metadata of the image, i.e. capture time, sequence number and source
+	///
+	const ImageMetadata& metadata() const
+	{
+		return _d_ptr->metadata();
+	}
+
+	///
+	/// Sets the metadata of the image. Set it before the image is handed over,
+	/// as the pixels are copied, if the image data is shared.
+	///
+	/// @param metadata The metadata
+	///
+	void setMetadata(const ImageMetadata& metadata)
+	{
+		_d_ptr->metadata() = metadata;
+	}
+
 	///
 	/// Returns a memory pointer to the first pixel in the image
 	/// @return The memory pointer to the first pixel
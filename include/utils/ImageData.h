@@ -8,6 +8,8 @@
 #include <cassert>
 #include <type_traits>
 #include <utils/ColorRgb.h>
+#include <utils/FrameBufferPool.h>
+#include <utils/ImageMetadata.h>
 
 // QT includes
 #include <QSharedData>
@@ -21,24 +23,45 @@ typedef SSIZE_T ssize_t;
 template <typename Pixel_T>
 class ImageData : public QSharedData
 {
+	// Pixels are stored in raw buffers of the frame buffer pool
+	static_assert(std::is_trivially_copyable<Pixel_T>::value && std::is_trivially_destructible<Pixel_T>::value,
+				  "ImageData requires trivial pixel types");
+
 public:
 	typedef Pixel_T pixel_type;
 
 	ImageData(unsigned width, unsigned height, const Pixel_T background) :
 		_width(width),
 		_height(height),
-		_pixels(new Pixel_T[width * height + 1])
+		_capacity(width * height + 1),
+		_pixels(allocatePixels(_capacity)),
+		_metadata()
 	{
 		std::fill(_pixels, _pixels + width * height, background);
 	}
 
+	///
+	/// Constructs image data of the given size with uninitialized pixels, to be overwritten completely
+	///
+	ImageData(unsigned width, unsigned height) :
+		_width(width),
+		_height(height),
+		_capacity(width * height + 1),
+		_pixels(allocatePixels(_capacity)),
+		_metadata()
+	{
+	}
+
 	ImageData(const ImageData & other) :
 		QSharedData(other),
 		_width(other._width),
 		_height(other._height),
-		_pixels(new Pixel_T[other._width * other._height + 1])
+		_capacity(other._width * other._height + 1),
+		_pixels(allocatePixels(_capacity)),
+		_metadata(other._metadata)
 	{
 		memcpy(_pixels, other._pixels, static_cast<ulong>(other._width) * static_cast<ulong>(other._height) * sizeof(Pixel_T));
+		FrameBufferPool::getInstance().countCopy();
 	}
 
 	ImageData& operator=(ImageData rhs)
@@ -52,13 +75,17 @@ public:
 		using std::swap;
 		swap(this->_width, s._width);
 		swap(this->_height, s._height);
+		swap(this->_capacity, s._capacity);
 		swap(this->_pixels, s._pixels);
+		swap(this->_metadata, s._metadata);
 	}
 
 	ImageData(ImageData&& src) noexcept
 		: _width(0)
 		, _height(0)
+		, _capacity(0)
 		, _pixels(NULL)
+		, _metadata()
 	{
 		src.swap(*this);
 	}
@@ -71,7 +98,7 @@ public:
 
 	~ImageData()
 	{
-		delete[] _pixels;
+		releasePixels(_pixels, _capacity);
 	}
 
 	inline unsigned width() const
@@ -114,16 +141,27 @@ public:
 		if (width == _width && height == _height)
 			return;
 
-		if ((width * height) > unsigned((_width * _height)))
+		if ((width * height + 1) > _capacity)
 		{
-			delete[] _pixels;
-			_pixels = new Pixel_T[width*height + 1];
+			releasePixels(_pixels, _capacity);
+			_capacity = width * height + 1;
+			_pixels = allocatePixels(_capacity);
 		}
 
 		_width = width;
 		_height = height;
 	}
 
+	inline const ImageMetadata& metadata() const
+	{
+		return _metadata;
+	}
+
+	inline ImageMetadata& metadata()
+	{
+		return _metadata;
+	}
+
 	Pixel_T* memptr()
 	{
 		return _pixels;
@@ -146,6 +184,8 @@ public:
 			const Pixel_T & color = _pixels[idx];
 			image.memptr()[idx] = ColorRgb{color.red, color.green, color.blue};
 		}
+
+		image.metadata() = _metadata;
 	}
 
 	ssize_t size() const
@@ -159,8 +199,9 @@ public:
 		{
 			_width = 1;
 			_height = 1;
-			delete[] _pixels;
-			_pixels = new Pixel_T[2];
+			releasePixels(_pixels, _capacity);
+			_capacity = 2;
+			_pixels = allocatePixels(_capacity);
 		}
 
 		memset(_pixels, 0, static_cast<unsigned long>(_width) * static_cast<unsigned long>(_height) * sizeof(Pixel_T));
@@ -172,11 +213,25 @@ private:
 		return y * _width + x;
 	}
 
+	static Pixel_T* allocatePixels(unsigned count)
+	{
+		return static_cast<Pixel_T*>(FrameBufferPool::getInstance().acquire(static_cast<size_t>(count) * sizeof(Pixel_T)));
+	}
+
+	static void releasePixels(Pixel_T* pixels, unsigned count)
+	{
+		FrameBufferPool::getInstance().release(pixels, static_cast<size_t>(count) * sizeof(Pixel_T));
+	}
+
 private:
 	/// The width of the image
 	unsigned _width;
 	/// The height of the image
 	unsigned _height;
+	/// The number of pixels the buffer can hold
+	unsigned _capacity;
 	/// The pixels of the image
 	Pixel_T* _pixels;
+	/// The capture time, sequence number and source of the image
+	ImageMetadata _metadata;
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+// QT includes
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+
+///
+/// Metadata of an image, handed over together with its pixels from the source (e.g. a grabber) to the LED device
+///
+struct ImageMetadata
+{
+	/// The capture time on the clock of LatencyStatistics::now() [ns], 0 if unknown
+	qint64 captureTime;
+	/// The number of the frame counted by its source, starting at 1. Frames skipped by the source
+	/// (e.g. dropped by the decoder) leave a gap in the numbers. 0 if unknown.
+	quint64 sequence;
+	/// The id of the source, see sourceIdOf(), 0 if unknown
+	quint32 sourceId;
+
+	ImageMetadata()
+		: captureTime(0)
+		, sequence(0)
+		, sourceId(0)
+	{
+	}
+
+	ImageMetadata(qint64 captureTime_, quint64 sequence_, quint32 sourceId_)
+		: captureTime(captureTime_)
+		, sequence(sequence_)
+		, sourceId(sourceId_)
+	{
+	}
+
+	///
+	/// Returns the number of frames skipped by the source between the given earlier frame and this one
+	///
+	/// @param[in] previous  The metadata of the previous frame received from the same input
+	///
+	/// @return The number of frames skipped, 0 if unknown or the frames are from different sources
+	///
+	quint64 skippedSince(const ImageMetadata& previous) const
+	{
+		if (sourceId != previous.sourceId || previous.sequence == 0 || sequence <= previous.sequence)
+		{
+			return 0;
+		}
+		return sequence - previous.sequence - 1;
+	}
+
+	///
+	/// Returns the id of the source with the given name, which is the same for the lifetime of the process
+	///
+	/// @param[in] name  The name of the source, e.g. the grabber name or device path
+	///
+	/// @return The id, never 0
+	///
+	static quint32 sourceIdOf(const QString& name)
+	{
+		const quint32 id = static_cast<quint32>(qHash(name));
+		return id != 0 ? id : 1;
+	}
+};
@@ -5,6 +5,14 @@
 #include <utils/Image.h>
 #include <utils/ColorRgb.h>
 
+#include <vector>
+
+///
+/// Converts, crops, flips and decimates images of the supported pixel formats to RGB images.
+/// The conversion of a source geometry is planned once (row kernel, row and column tables with cropping,
+/// 3D mode and flipping applied) and reused as long as the geometry and the settings do not change.
+/// An instance must not be used by multiple threads concurrently.
+///
 class ImageResampler
 {
 public:
@@ -16,8 +24,80 @@ public:
 	void setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom);
 	void setVideoMode(VideoMode mode) { _videoMode = mode; }
 	void setFlipMode(FlipMode mode) { _flipMode = mode; }
+
+	///
+	/// Selects how the pixels of a decimation block are reduced to one output pixel
+	///
+	/// @param[in] averaging  True, to average all pixels of the block (area averaging),
+	///                       false to take the center pixel (point sampling, the default)
+	///
+	void setPixelDecimationAveraging(bool averaging) { _pixelDecimationAveraging = averaging; }
 	void processImage(const uint8_t * data, int width, int height, int lineLength, PixelFormat pixelFormat, Image<ColorRgb> & outputImage) const;
 
+	///
+	/// Offsets of one source row and the output row it is converted to
+	///
+	struct SourceRow
+	{
+		/// Offset of the row (luma plane for planar formats) [bytes]
+		int yOffset;
+		/// Offset of the row's chroma in the U (NV12: UV) plane [bytes]
+		int uOffset;
+		/// Offset of the row's chroma in the V plane [bytes]
+		int vOffset;
+		/// Offset of the output row [pixels]
+		size_t destination;
+	};
+
+	///
+	/// Converts the given source columns of a row (YUV formats: gathers their planar Y, U and V samples)
+	///
+	typedef void (*RowKernel)(const uint8_t* data, const SourceRow& row, const int* columns, int count, uint8_t* samples, ColorRgb* rgb);
+
+private:
+	///
+	/// Conversion of a source geometry with the settings it was built for
+	///
+	struct Plan
+	{
+		int width;
+		int height;
+		int lineLength;
+		PixelFormat pixelFormat;
+		int horizontalDecimation;
+		int verticalDecimation;
+		int cropLeft;
+		int cropRight;
+		int cropTop;
+		int cropBottom;
+		VideoMode videoMode;
+		FlipMode flipMode;
+		bool averaging;
+
+		int outputWidth;
+		int outputHeight;
+
+		/// Row kernel of the pixel format, null if not supported
+		RowKernel convertRow;
+		/// Row kernel gathering the samples of YUV formats for area averaging, null otherwise
+		RowKernel gatherRow;
+
+		/// Point sampling: one row per output row and the source column of each output pixel, flipping applied.
+		/// Area averaging: all rows and columns of the decimation blocks, rows are flipped via their destination.
+		std::vector<SourceRow> rows;
+		std::vector<int> columns;
+		bool flipColumns;
+
+		/// Scratch rows
+		std::vector<uint8_t> samples;
+		std::vector<uint16_t> columnSums;
+		std::vector<uint32_t> blockSums;
+		std::vector<uint8_t> blockSamples;
+	};
+
+	bool isPlannedFor(int width, int height, int lineLength, PixelFormat pixelFormat) const;
+	void buildPlan(int width, int height, int lineLength, PixelFormat pixelFormat) const;
+
 private:
 	int _horizontalDecimation;
 	int _verticalDecimation;
@@ -27,5 +107,9 @@ private:
 	int _cropBottom;
 	VideoMode _videoMode;
 	FlipMode _flipMode;
+	bool _pixelDecimationAveraging;
+
+	/// Conversion planned for the last source geometry
+	mutable Plan _plan;
 };
 
@@ -0,0 +1,71 @@
+#pragma once
+
+// QT includes
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMap>
+
+///
+/// Throttles the frames of an input (capture or network stream), while it is hidden behind a higher priority.
+/// A hidden input forwards one frame per keep-alive interval only, so its priority stays active and its image
+/// is almost current when it gets visible again.
+/// The hidden state is either set directly or evaluated from the visible priorities of all instances: the input
+/// is hidden, when a higher priority is visible on every instance.
+/// The hidden state may be read from any thread, frames have to be checked by a single thread.
+///
+class InputThrottle
+{
+public:
+	/// Interval of the frames forwarded by a hidden input [ms], below the inactive timeouts of the capture interfaces
+	static constexpr int KEEP_ALIVE_INTERVAL_MS = 500;
+
+	InputThrottle();
+
+	///
+	/// @brief Set the priority of the input
+	/// @param[in] priority  The priority, -1 if the input is not registered
+	///
+	void setPriority(int priority);
+
+	///
+	/// @brief Update the visible priority of an instance
+	/// @param[in] instance         The instance index
+	/// @param[in] visiblePriority  The visible priority, -1 if the instance stopped
+	///
+	void setVisiblePriority(int instance, int visiblePriority);
+
+	///
+	/// @brief Set the hidden state of an input evaluating its visibility itself
+	/// @param[in] hidden  True, if the input is hidden on all instances
+	///
+	void setHidden(bool hidden);
+
+	///
+	/// @brief Check, if the input is hidden (thread safe)
+	///
+	bool isHidden() const;
+
+	///
+	/// @brief Check, if a frame should be forwarded.
+	/// A hidden input forwards a frame per keep-alive interval, and in time before the frames time out.
+	///
+	/// @param[in] timeout_ms  The timeout of the frame [ms], endless if not positive
+	///
+	/// @return True, if the frame should be forwarded
+	///
+	bool isFrameDue(int timeout_ms = -1);
+
+private:
+	/// Evaluate the hidden state from the visible priorities
+	void evaluate();
+
+	int _priority;
+
+	/// The visible priority by instance index
+	QMap<int, int> _visiblePriorities;
+
+	QAtomicInt _hidden;
+
+	/// Time since the last frame forwarded while hidden
+	QElapsedTimer _keepAliveTimer;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+// STL includes
+#include <vector>
+
+// QT includes
+#include <QMutex>
+#include <QtGlobal>
+
+///
+/// Process wide statistics of the latency from capturing a frame to writing the LED colors derived from it
+/// to the LED device. Frames carry their capture time (see Image::captureTime()) on the monotonic clock
+/// returned by now(). The percentiles are evaluated over the most recent samples. The statistics are thread safe.
+///
+class LatencyStatistics
+{
+public:
+	/// Number of recent samples the percentiles are evaluated over
+	static constexpr int WINDOW_SIZE = 1024;
+
+	///
+	/// Latency statistics of the recent samples
+	///
+	struct Statistics
+	{
+		/// Samples recorded since start
+		quint64 samples;
+		/// Samples the percentiles are evaluated over
+		quint32 windowSamples;
+		/// Latency percentiles and maximum of the recent samples [ms]
+		double p50Ms;
+		double p95Ms;
+		double p99Ms;
+		double maxMs;
+	};
+
+	///
+	/// Returns the process wide statistics
+	///
+	static LatencyStatistics& getInstance();
+
+	///
+	/// Returns the current time of the monotonic clock capture times refer to [ns]
+	/// (CLOCK_MONOTONIC on Linux, also used for the timestamps of V4L2 buffers)
+	///
+	static qint64 now();
+
+	///
+	/// Records the latency of LED colors derived from a frame captured at the given time and written now
+	///
+	/// @param[in] captureTime  The capture time [ns], see now(). Unknown capture times (0) are ignored.
+	///
+	void addSample(qint64 captureTime);
+
+	///
+	/// Returns the statistics
+	///
+	Statistics statistics() const;
+
+private:
+	LatencyStatistics();
+
+	mutable QMutex _mutex;
+
+	quint64 _samples;
+	/// Ring buffer of the recent latencies [ns]
+	std::vector<qint64> _window;
+	/// Index of the next sample in the ring buffer
+	int _next;
+};
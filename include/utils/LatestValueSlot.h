@@ -0,0 +1,149 @@
+#pragma once
+
+// STL includes
+#include <utility>
+
+// QT includes
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QMutexLocker>
+
+///
+/// Statistics of a LatestValueSlot since construction
+///
+struct LatestValueSlotStatistics
+{
+	/// Values published
+	quint32 published;
+	/// Values replaced by a later one before they were taken
+	quint32 coalesced;
+
+	double coalesceRate() const { return published > 0 ? static_cast<double>(coalesced) / published : 0.0; }
+
+	LatestValueSlotStatistics& operator+=(const LatestValueSlotStatistics& other)
+	{
+		published += other.published;
+		coalesced += other.coalesced;
+		return *this;
+	}
+};
+
+///
+/// Hands the latest value over from a producer thread to a consumer thread without blocking the consumer (triple buffer).
+/// A value published while the previous one was not taken yet replaces it, i.e. the previous one is coalesced.
+/// The consumer has to be notified once per value taken only, so a consumer slower than its producer gets the
+/// newest value instead of a growing backlog of queued values.
+/// The buffers are exchanged by a single atomic operation, the consumer never takes a lock. Producers are serialised
+/// by a mutex, which is uncontended for the usual single producer (e.g. an effect still stopping is a second one).
+/// Only the value not taken yet is held by the slot, taken or replaced values are released immediately.
+///
+template <typename Value_T>
+class LatestValueSlot
+{
+public:
+	using Statistics = LatestValueSlotStatistics;
+
+	LatestValueSlot()
+		: _buffers()
+		, _middle(1)
+		, _back(2)
+		, _front(0)
+		, _published(0)
+		, _coalesced(0)
+	{
+	}
+
+	///
+	/// Publishes the latest value, replacing one not taken yet (producer)
+	///
+	/// @param[in] value  The value
+	///
+	/// @return True, if the previous value was taken, i.e. the consumer has to be notified to take() this one
+	///
+	bool publish(const Value_T& value)
+	{
+		QMutexLocker lock(&_producerMutex);
+
+		_buffers[_back] = value;
+		const int previous = _middle.fetchAndStoreAcquireRelease(_back | FRESH);
+		_back = previous & INDEX_MASK;
+
+		_published.fetchAndAddRelaxed(1);
+		if ((previous & FRESH) != 0)
+		{
+			release(_back);
+			_coalesced.fetchAndAddRelaxed(1);
+			return false;
+		}
+		return true;
+	}
+
+	///
+	/// Takes the value published last, if it was not taken yet (consumer)
+	///
+	/// @param[out] value  The value taken
+	///
+	/// @return True, if a value was taken
+	///
+	bool take(Value_T& value)
+	{
+		if ((_middle.loadAcquire() & FRESH) == 0)
+		{
+			return false;
+		}
+
+		_front = _middle.fetchAndStoreAcquireRelease(_front) & INDEX_MASK;
+		value = std::move(_buffers[_front]);
+		release(_front);
+		return true;
+	}
+
+	///
+	/// Drops the value published last, if it was not taken yet (consumer)
+	///
+	void discard()
+	{
+		if ((_middle.loadAcquire() & FRESH) != 0)
+		{
+			_front = _middle.fetchAndStoreAcquireRelease(_front) & INDEX_MASK;
+			release(_front);
+		}
+	}
+
+	///
+	/// Returns the statistics since construction (thread safe)
+	///
+	Statistics statistics() const
+	{
+		return { quint32(_published), quint32(_coalesced) };
+	}
+
+private:
+	///
+	/// Releases the value of a buffer owned by the calling side, a released buffer is only assigned to afterwards
+	///
+	void release(int index)
+	{
+		Value_T released(std::move(_buffers[index]));
+	}
+
+	/// Bits of the buffer index in _middle
+	static constexpr int INDEX_MASK = 0x3;
+	/// Flag of _middle, set while the middle buffer holds a value not taken yet
+	static constexpr int FRESH = 0x4;
+
+	/// The buffers written by the producer (back), exchanged (middle) and read by the consumer (front)
+	Value_T _buffers[3];
+
+	/// Index of the middle buffer and the FRESH flag, the only state shared by producer and consumer
+	QAtomicInt _middle;
+	/// Index of the buffer written next, owned by the producer
+	int _back;
+	/// Index of the buffer read last, owned by the consumer
+	int _front;
+
+	QMutex _producerMutex;
+
+	QAtomicInteger<quint32> _published;
+	QAtomicInteger<quint32> _coalesced;
+};
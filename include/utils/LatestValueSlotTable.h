@@ -0,0 +1,312 @@
+#pragma once
+
+// STL includes
+#include <vector>
+
+// QT includes
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QMetaObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QObject>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QWriteLocker>
+
+// utils includes
+#include <utils/LatestValueSlot.h>
+
+///
+/// Table of LatestValueSlots by index, which hands the latest values over from producer threads to a receiver object.
+/// The receiver is woken by a queued invocation of its method with the index of the slot holding a value not taken yet.
+///
+/// The table is shared by a QSharedPointer, so producers which keep their own reference (e.g. captured by a
+/// Qt::DirectConnection functor) may publish safely while the receiver is destroyed: the receiver closes the table
+/// before, which waits for the producers publishing at that moment. Values published later are dropped.
+/// Publishing takes the read lock of the table and the producer mutex of the slot, the receiver takes no lock except
+/// when it opens or closes the table. The read lock is shared by all producers, the slot mutex is uncontended as long
+/// as a single producer publishes to an index.
+/// A slot is created by the receiver and kept until the table is destroyed.
+///
+/// Producers queueing a clear of an index to the receiver post it by requestClear(), the receiver runs it by runClear().
+/// Values are stamped with the number of clears requested before, so a value published after a clear is only taken
+/// once that clear ran, even if the receiver was woken for an earlier value queued ahead of the clear.
+///
+template <typename Value_T>
+class LatestValueSlotTable
+{
+public:
+	///
+	/// A published value and the number of clears requested before it
+	///
+	struct StampedValue
+	{
+		Value_T value;
+		quint32 clearSequence;
+	};
+
+	using Slot = LatestValueSlot<StampedValue>;
+
+	///
+	/// @param[in] size  The number of indexes
+	///
+	explicit LatestValueSlotTable(int size)
+		: _receiver(nullptr)
+		, _method(nullptr)
+		, _clearRequests(0)
+		, _clearsProcessed(0)
+		, _keepSequence(1)
+		, _entries(static_cast<size_t>(size))
+	{
+	}
+
+	~LatestValueSlotTable()
+	{
+		for (const auto& entry : _entries)
+		{
+			delete entry.slot.loadAcquire();
+		}
+	}
+
+	LatestValueSlotTable(const LatestValueSlotTable&) = delete;
+	LatestValueSlotTable& operator=(const LatestValueSlotTable&) = delete;
+
+	///
+	/// @brief Attach the receiver (receiver's thread)
+	/// @param[in] receiver  The receiver
+	/// @param[in] method    The name of the receiver's slot taking the index as int argument
+	///
+	void open(QObject* receiver, const char* method)
+	{
+		QWriteLocker lock(&_receiverLock);
+		_receiver = receiver;
+		_method = method;
+	}
+
+	///
+	/// @brief Detach the receiver before it is destroyed (receiver's thread).
+	/// Waits for the producers publishing at the moment, values published later are dropped.
+	///
+	void close()
+	{
+		QWriteLocker lock(&_receiverLock);
+		_receiver = nullptr;
+		_method = nullptr;
+	}
+
+	///
+	/// @brief Create the slot of an index, if it does not exist yet (receiver's thread)
+	/// @param[in] index  The index
+	///
+	void create(int index)
+	{
+		if (isValid(index) && _entries[index].slot.loadAcquire() == nullptr)
+		{
+			_entries[index].slot.storeRelease(new Slot());
+		}
+	}
+
+	///
+	/// @brief Publish a value to the slot of an index and wake the receiver, if it took the previous value (producer)
+	/// @param[in] index  The index
+	/// @param[in] value  The value
+	/// @return False, if the slot was not created or the table is closed
+	///
+	bool publish(int index, const Value_T& value)
+	{
+		Slot* slot = get(index);
+		if (slot == nullptr)
+		{
+			return false;
+		}
+
+		QReadLocker lock(&_receiverLock);
+		if (_receiver == nullptr)
+		{
+			return false;
+		}
+
+		if (slot->publish(StampedValue{value, quint32(_clearRequests)}))
+		{
+			QMetaObject::invokeMethod(_receiver, _method, Qt::QueuedConnection, Q_ARG(int, index));
+		}
+		return true;
+	}
+
+	///
+	/// @brief Take the value published last to the slot of an index (receiver's thread).
+	/// A value published after a clear, which did not run yet, is held back until runClear() wakes the receiver again.
+	/// @param[in]  index  The index
+	/// @param[out] value  The value taken
+	/// @return True, if a value was taken
+	///
+	bool take(int index, Value_T& value)
+	{
+		Entry* entry = fetch(index);
+		if (entry == nullptr || entry->pending.clearSequence > _clearsProcessed)
+		{
+			return false;
+		}
+
+		value = std::move(entry->pending.value);
+		entry->hasPending = false;
+		return true;
+	}
+
+	///
+	/// @brief Drop the values of an index published before the clear running at the moment (receiver's thread).
+	/// Outside of runClear() all values are dropped, which were not held back for a clear still queued.
+	/// @param[in] index  The index
+	///
+	void discard(int index)
+	{
+		Entry* entry = fetch(index);
+		if (entry != nullptr && entry->pending.clearSequence < _keepSequence)
+		{
+			entry->pending.value = Value_T();
+			entry->hasPending = false;
+		}
+	}
+
+	///
+	/// @brief Post a clear to the receiver (producer). Values published by the calling thread afterwards are taken
+	/// only after the receiver ran the clear by runClear().
+	/// @param[in] queueClear  The function queueing the clear, taking the receiver as QObject* and the sequence of the
+	/// 					   clear as quint32, which is passed on to runClear()
+	/// @return False, if the table is closed
+	///
+	template <typename Func_T>
+	bool requestClear(Func_T queueClear)
+	{
+		QReadLocker lock(&_receiverLock);
+		if (_receiver == nullptr)
+		{
+			return false;
+		}
+
+		// clears are queued in the order of their sequence
+		QMutexLocker clearLock(&_clearMutex);
+		const quint32 sequence = quint32(_clearRequests) + 1;
+		queueClear(_receiver, sequence);
+		_clearRequests.storeRelease(sequence);
+		return true;
+	}
+
+	///
+	/// @brief Run a clear posted by requestClear() (receiver's thread). Values published after the clear was requested
+	/// survive discard() called by the clear function and are taken afterwards.
+	/// @param[in] sequence  The sequence of the clear
+	/// @param[in] clear     The function clearing the receiver's state
+	///
+	template <typename Func_T>
+	void runClear(quint32 sequence, Func_T clear)
+	{
+		_clearsProcessed = sequence;
+		_keepSequence = sequence;
+		clear();
+		_keepSequence = sequence + 1;
+
+		// values held back for this clear, a wake-up queued now keeps the order with calls queued after the clear
+		for (int index = 0; index < static_cast<int>(_entries.size()); ++index)
+		{
+			if (_entries[index].hasPending && _receiver != nullptr)
+			{
+				QMetaObject::invokeMethod(_receiver, _method, Qt::QueuedConnection, Q_ARG(int, index));
+			}
+		}
+	}
+
+	///
+	/// @brief Call a function with the receiver, unless the table is closed (thread safe).
+	/// The receiver is not destroyed during the call, the function must not block on the receiver's thread.
+	/// @param[in] func  The function taking the receiver as QObject*
+	/// @return False, if the table is closed
+	///
+	template <typename Func_T>
+	bool withReceiver(Func_T func) const
+	{
+		QReadLocker lock(&_receiverLock);
+		if (_receiver == nullptr)
+		{
+			return false;
+		}
+		func(_receiver);
+		return true;
+	}
+
+	///
+	/// @brief Get the statistics of all slots (thread safe)
+	///
+	LatestValueSlotStatistics statistics() const
+	{
+		LatestValueSlotStatistics statistics {0, 0};
+		for (const auto& entry : _entries)
+		{
+			const Slot* current = entry.slot.loadAcquire();
+			if (current != nullptr)
+			{
+				statistics += current->statistics();
+			}
+		}
+		return statistics;
+	}
+
+private:
+	///
+	/// The slot of an index and the value taken from it, but held back for a clear (receiver)
+	///
+	struct Entry
+	{
+		QAtomicPointer<Slot> slot;
+		StampedValue pending {Value_T(), 0};
+		bool hasPending {false};
+	};
+
+	bool isValid(int index) const
+	{
+		return index >= 0 && index < static_cast<int>(_entries.size());
+	}
+
+	Slot* get(int index) const
+	{
+		return isValid(index) ? _entries[index].slot.loadAcquire() : nullptr;
+	}
+
+	///
+	/// Moves the value published last into the pending value of an index (receiver)
+	/// @return The entry, if it holds a pending value
+	///
+	Entry* fetch(int index)
+	{
+		Slot* slot = get(index);
+		if (slot == nullptr)
+		{
+			return nullptr;
+		}
+
+		Entry& entry = _entries[index];
+		if (slot->take(entry.pending))
+		{
+			entry.hasPending = true;
+		}
+		return entry.hasPending ? &entry : nullptr;
+	}
+
+	/// Guards the receiver against being detached while producers wake it
+	mutable QReadWriteLock _receiverLock;
+	QObject* _receiver;
+	const char* _method;
+
+	/// Serialises the producers requesting a clear
+	QMutex _clearMutex;
+	/// Sequence of the clear requested last, stamped on the values published
+	QAtomicInteger<quint32> _clearRequests;
+	/// Sequence of the clear run last (receiver)
+	quint32 _clearsProcessed;
+	/// Values stamped with at least this sequence survive discard() (receiver)
+	quint32 _keepSequence;
+
+	/// The slots by index, created once and never removed
+	std::vector<Entry> _entries;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+// STL includes
+#include <list>
+#include <utility>
+
+// QT includes
+#include <QAtomicInteger>
+
+///
+/// A small cache holding the most recently used values, evicting the least recently used one when full.
+/// Entries are searched linearly, so the cache is meant for a handful of entries with cheap key comparison.
+/// Lookups and modifications have to be done by a single thread, the statistics may be read from any thread.
+///
+template <typename Key_T, typename Value_T>
+class LruCache
+{
+public:
+	///
+	/// Cache statistics since construction
+	///
+	struct Statistics
+	{
+		quint32 hits;
+		quint32 misses;
+		quint32 size;
+		quint32 capacity;
+
+		double hitRate() const { return (hits + misses) > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+	};
+
+	///
+	/// @param[in] capacity  The maximum number of entries (minimum 1)
+	///
+	explicit LruCache(quint32 capacity)
+		: _capacity(capacity > 0 ? capacity : 1)
+		, _hits(0)
+		, _misses(0)
+		, _size(0)
+	{
+	}
+
+	///
+	/// Looks up the value of the given key and marks it as most recently used
+	///
+	/// @param[in] key  The key to look up
+	///
+	/// @return The value or null, if the key is not cached. The pointer is valid until the cache is modified.
+	///
+	Value_T* find(const Key_T& key)
+	{
+		for (auto entry = _entries.begin(); entry != _entries.end(); ++entry)
+		{
+			if (entry->first == key)
+			{
+				_entries.splice(_entries.begin(), _entries, entry);
+				_hits.fetchAndAddRelaxed(1);
+				return &_entries.front().second;
+			}
+		}
+
+		_misses.fetchAndAddRelaxed(1);
+		return nullptr;
+	}
+
+	///
+	/// Checks if the given key is cached, without marking it as used or counting a lookup
+	///
+	/// @param[in] key  The key to look up
+	///
+	bool contains(const Key_T& key) const
+	{
+		for (const auto& entry : _entries)
+		{
+			if (entry.first == key)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	///
+	/// Inserts or replaces the value of the given key as most recently used entry.
+	/// The least recently used entry is evicted, if the cache is full.
+	///
+	/// @param[in] key    The key
+	/// @param[in] value  The value
+	///
+	void insert(const Key_T& key, Value_T value)
+	{
+		for (auto entry = _entries.begin(); entry != _entries.end(); ++entry)
+		{
+			if (entry->first == key)
+			{
+				_entries.erase(entry);
+				break;
+			}
+		}
+
+		_entries.emplace_front(key, std::move(value));
+		if (_entries.size() > _capacity)
+		{
+			_entries.pop_back();
+		}
+		_size = static_cast<quint32>(_entries.size());
+	}
+
+	///
+	/// Removes all entries, the statistics are kept
+	///
+	void clear()
+	{
+		_entries.clear();
+		_size = 0;
+	}
+
+	///
+	/// Returns the statistics since construction (thread safe)
+	///
+	Statistics statistics() const
+	{
+		return { quint32(_hits), quint32(_misses), quint32(_size), _capacity };
+	}
+
+private:
+	const quint32 _capacity;
+
+	/// Entries ordered from most to least recently used
+	std::list<std::pair<Key_T, Value_T>> _entries;
+
+	QAtomicInteger<quint32> _hits;
+	QAtomicInteger<quint32> _misses;
+	QAtomicInteger<quint32> _size;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+// STL includes
+#include <functional>
+#include <memory>
+#include <vector>
+
+// QT includes
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+///
+/// A pool of persistent worker threads executing the tasks of a single job in parallel.
+/// The calling thread takes part in the execution and returns, once all tasks of the job are done.
+/// Jobs are executed one after the other, so a pool should be owned by the component running the jobs.
+///
+class WorkerPool
+{
+public:
+	///
+	/// Constructs a pool processing jobs with the given number of threads, including the calling thread.
+	/// I.e. threadCount - 1 worker threads are started.
+	///
+	/// @param[in] threadCount  The number of threads executing the tasks of a job (minimum 1)
+	/// @param[in] name         The name of the worker threads
+	///
+	explicit WorkerPool(int threadCount, const QString& name = "WorkerPool");
+	~WorkerPool();
+
+	///
+	/// Returns the number of threads executing the tasks of a job, including the calling thread
+	///
+	/// @return The number of threads
+	///
+	int threadCount() const;
+
+	///
+	/// Executes the tasks 0 to taskCount-1 by calling the given function with the task index.
+	/// Tasks are picked up in ascending order by the calling thread and the worker threads.
+	///
+	/// @param[in] taskCount  The number of tasks of the job
+	/// @param[in] task       The function executing a task, it must be thread safe across different tasks
+	///
+	void run(int taskCount, const std::function<void(int)>& task);
+
+private:
+	class Worker : public QThread
+	{
+	public:
+		explicit Worker(WorkerPool* pool) : _pool(pool) {}
+
+	protected:
+		void run() override { _pool->executeTasks(); }
+
+	private:
+		WorkerPool* _pool;
+	};
+
+	///
+	/// Worker thread loop, executes tasks of the current job until the pool is stopped
+	///
+	void executeTasks();
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+
+	/// Serializes the jobs
+	QMutex _jobMutex;
+
+	/// Protects the job's state below
+	QMutex _mutex;
+	QWaitCondition _tasksAvailable;
+	QWaitCondition _tasksDone;
+
+	const std::function<void(int)>* _task;
+	int _taskCount;
+	int _nextTask;
+	int _finishedTasks;
+	bool _stopped;
+};
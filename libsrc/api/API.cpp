@@ -194,7 +194,7 @@ bool API::setImage(ImageCmdData &data, hyperion::Components comp, QString &reply
     memcpy(image.memptr(), data.data.data(), data.data.size());
 
     QMetaObject::invokeMethod(_hyperion, "registerInput", Qt::QueuedConnection, Q_ARG(int, data.priority), Q_ARG(hyperion::Components, comp), Q_ARG(QString, data.origin), Q_ARG(QString, data.imgName));
-    QMetaObject::invokeMethod(_hyperion, "setInputImage", Qt::QueuedConnection, Q_ARG(int, data.priority), Q_ARG(Image<ColorRgb>, image), Q_ARG(int64_t, data.duration));
+    _hyperion->postInputImage(data.priority, image, data.duration);
 
     return true;
 }
@@ -203,7 +203,7 @@ bool API::clearPriority(int priority, QString &replyMsg, hyperion::Components ca
 {
     if (priority < 0 || (priority > 0 && priority < 254))
     {
-        QMetaObject::invokeMethod(_hyperion, "clear", Qt::QueuedConnection, Q_ARG(int, priority));
+        _hyperion->postClear(priority);
     }
     else
     {
@@ -76,6 +76,9 @@
 #include <utils/ColorSys.h>
 #include <utils/Process.h>
 #include <utils/JsonUtils.h>
+#include <utils/FrameBufferPool.h>
+#include <utils/FrameDecoderStatistics.h>
+#include <utils/LatencyStatistics.h>
 
 // ledmapping int <> string transform methods
 #include <hyperion/ImageProcessor.h>
@@ -386,6 +389,63 @@ void JsonAPI::handleSysInfoCommand(const QJsonObject &, const QString &command,
 	hyperion["rootPath"] = _instanceManager->getRootPath();
 	hyperion["readOnlyMode"] = _hyperion->getReadOnlyMode();
 
+	const ImageProcessor::MappingCache::Statistics mappingCacheStatistics = _hyperion->getImageProcessor()->getMappingCacheStatistics();
+	QJsonObject ledMappingCache;
+	ledMappingCache["hits"] = static_cast<qint64>(mappingCacheStatistics.hits);
+	ledMappingCache["misses"] = static_cast<qint64>(mappingCacheStatistics.misses);
+	ledMappingCache["hitRate"] = mappingCacheStatistics.hitRate();
+	ledMappingCache["size"] = static_cast<int>(mappingCacheStatistics.size);
+	ledMappingCache["capacity"] = static_cast<int>(mappingCacheStatistics.capacity);
+	hyperion["ledMappingCache"] = ledMappingCache;
+
+	const LatestValueSlotStatistics inputSlotStatistics = _hyperion->getInputSlotStatistics();
+	QJsonObject inputSlots;
+	inputSlots["published"] = static_cast<qint64>(inputSlotStatistics.published);
+	inputSlots["coalesced"] = static_cast<qint64>(inputSlotStatistics.coalesced);
+	inputSlots["coalesceRate"] = inputSlotStatistics.coalesceRate();
+	hyperion["inputSlots"] = inputSlots;
+
+	const FrameBufferPool::Statistics frameBufferPoolStatistics = FrameBufferPool::getInstance().statistics();
+	QJsonObject frameBufferPool;
+	frameBufferPool["acquired"] = static_cast<qint64>(frameBufferPoolStatistics.acquired);
+	frameBufferPool["reused"] = static_cast<qint64>(frameBufferPoolStatistics.reused);
+	frameBufferPool["reuseRate"] = frameBufferPoolStatistics.reuseRate();
+	frameBufferPool["released"] = static_cast<qint64>(frameBufferPoolStatistics.released);
+	frameBufferPool["discarded"] = static_cast<qint64>(frameBufferPoolStatistics.discarded);
+	frameBufferPool["freeBuffers"] = static_cast<qint64>(frameBufferPoolStatistics.freeBuffers);
+	frameBufferPool["freeBytes"] = static_cast<qint64>(frameBufferPoolStatistics.freeBytes);
+	frameBufferPool["copies"] = static_cast<qint64>(frameBufferPoolStatistics.copies);
+	hyperion["frameBufferPool"] = frameBufferPool;
+
+	const FrameDecoderStatistics::Statistics frameDecoderStatistics = FrameDecoderStatistics::getInstance().statistics();
+	QJsonObject frameDecoder;
+	frameDecoder["threads"] = static_cast<int>(frameDecoderStatistics.threads);
+	frameDecoder["decoded"] = static_cast<qint64>(frameDecoderStatistics.decoded);
+	frameDecoder["failed"] = static_cast<qint64>(frameDecoderStatistics.failed);
+	frameDecoder["dropped"] = static_cast<qint64>(frameDecoderStatistics.dropped);
+	frameDecoder["reordered"] = static_cast<qint64>(frameDecoderStatistics.reordered);
+	QJsonArray mjpegScales;
+	for (int scale = 0; scale < FrameDecoderStatistics::MJPEG_SCALES; ++scale)
+	{
+		QJsonObject mjpegScale;
+		mjpegScale["scale"] = QString("1/%1").arg(1 << scale);
+		mjpegScale["frames"] = static_cast<qint64>(frameDecoderStatistics.mjpeg[scale].frames);
+		mjpegScale["averageDecodeTimeMs"] = frameDecoderStatistics.mjpeg[scale].averageMs();
+		mjpegScales.append(mjpegScale);
+	}
+	frameDecoder["mjpeg"] = mjpegScales;
+	hyperion["frameDecoder"] = frameDecoder;
+
+	const LatencyStatistics::Statistics latencyStatistics = LatencyStatistics::getInstance().statistics();
+	QJsonObject captureLatency;
+	captureLatency["samples"] = static_cast<qint64>(latencyStatistics.samples);
+	captureLatency["windowSamples"] = static_cast<int>(latencyStatistics.windowSamples);
+	captureLatency["p50Ms"] = latencyStatistics.p50Ms;
+	captureLatency["p95Ms"] = latencyStatistics.p95Ms;
+	captureLatency["p99Ms"] = latencyStatistics.p99Ms;
+	captureLatency["maxMs"] = latencyStatistics.maxMs;
+	hyperion["captureLatency"] = captureLatency;
+
 	info["hyperion"] = hyperion;
 
 	// send the result
@@ -427,6 +487,12 @@ void JsonAPI::handleServerInfoCommand(const QJsonObject &message, const QString
 		item["active"] = (priorityInfo.timeoutTime_ms >= -1);
 		item["visible"] = (priority == currentPriority);
 
+		// frames of a numbering source (grabbers) not reaching the input
+		if (priorityInfo.metadata.sequence > 0)
+		{
+			item["skippedFrames"] = static_cast<qint64>(priorityInfo.skippedFrames);
+		}
+
 		if (priorityInfo.componentId == hyperion::COMP_COLOR && !priorityInfo.ledColors.empty())
 		{
 			QJsonObject LEDcolor;
@@ -222,6 +222,12 @@ void JsonCB::handlePriorityUpdate(int currentPriority, const PriorityMuxer::Inpu
 		item["active"] = (priorityInfo.timeoutTime_ms >= -1);
 		item["visible"] = (priority == currentPriority);
 
+		// frames of a numbering source (grabbers) not reaching the input
+		if (priorityInfo.metadata.sequence > 0)
+		{
+			item["skippedFrames"] = static_cast<qint64>(priorityInfo.skippedFrames);
+		}
+
 		if(priorityInfo.componentId == hyperion::COMP_COLOR && !priorityInfo.ledColors.empty())
 		{
 			QJsonObject LEDcolor;
@@ -5,8 +5,125 @@
 #include <blackborder/BlackBorderDetector.h>
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BLACKBORDER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define BLACKBORDER_NEON
+#endif
+
 using namespace hyperion;
 
+namespace {
+
+///
+/// Returns the maximum of the given bytes and raises the column accumulator to them
+///
+/// @param[in]     data         The bytes of a row segment
+/// @param[in,out] accumulator  The column maxima of the same bytes
+/// @param[in]     count        The number of bytes
+///
+/// @return The maximum byte
+///
+uint8_t reduceBytes(const uint8_t* data, uint8_t* accumulator, int count)
+{
+	int idx = 0;
+	uint8_t result = 0;
+
+#if defined(BLACKBORDER_SSE2)
+	if (count >= 16)
+	{
+		__m128i maximum = _mm_setzero_si128();
+		for (; idx + 16 <= count; idx += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + idx));
+			const __m128i column = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + idx));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + idx), _mm_max_epu8(column, bytes));
+			maximum = _mm_max_epu8(maximum, bytes);
+		}
+		maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 8));
+		maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 4));
+		maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 2));
+		maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 1));
+		result = static_cast<uint8_t>(_mm_cvtsi128_si32(maximum) & 0xFF);
+	}
+#elif defined(BLACKBORDER_NEON)
+	if (count >= 16)
+	{
+		uint8x16_t maximum = vdupq_n_u8(0);
+		for (; idx + 16 <= count; idx += 16)
+		{
+			const uint8x16_t bytes = vld1q_u8(data + idx);
+			vst1q_u8(accumulator + idx, vmaxq_u8(vld1q_u8(accumulator + idx), bytes));
+			maximum = vmaxq_u8(maximum, bytes);
+		}
+		uint8x8_t half = vmax_u8(vget_low_u8(maximum), vget_high_u8(maximum));
+		half = vpmax_u8(half, half);
+		half = vpmax_u8(half, half);
+		half = vpmax_u8(half, half);
+		result = vget_lane_u8(half, 0);
+	}
+#endif
+
+	for (; idx < count; ++idx)
+	{
+		accumulator[idx] = qMax(accumulator[idx], data[idx]);
+		result = qMax(result, data[idx]);
+	}
+	return result;
+}
+
+} // namespace
+
+BlackBorderLineSummaries::BlackBorderLineSummaries()
+	: _width(0)
+	, _height(0)
+{
+}
+
+void BlackBorderLineSummaries::resize(int width, int height)
+{
+	_width = width;
+	_height = height;
+	_rows.assign(static_cast<size_t>(height) * ROW_SEGMENTS, 0);
+	_columns.assign(static_cast<size_t>(width) * COLUMN_SEGMENTS, 0);
+}
+
+void BlackBorderLineSummaries::scan(const Image<ColorRgb> & image)
+{
+	resize(image.width(), image.height());
+
+	// the pixels are only reduced to their maximum channel per column after the scan,
+	// so rows are streamed as plain bytes
+	const int rowBytes = _width * 3;
+	_columnBytes.assign(static_cast<size_t>(rowBytes) * COLUMN_SEGMENTS, 0);
+
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(image.memptr());
+	for (int y = 0; y < _height; ++y)
+	{
+		const uint8_t* row = data + static_cast<size_t>(y) * rowBytes;
+		uint8_t* rowMax = &_rows[static_cast<size_t>(y) * ROW_SEGMENTS];
+		uint8_t* columnBytes = &_columnBytes[static_cast<size_t>(columnSegment(y)) * rowBytes];
+		for (int segment = 0; segment < ROW_SEGMENTS; ++segment)
+		{
+			const int begin = segmentBegin(_width, ROW_SEGMENTS, segment) * 3;
+			const int end = segmentBegin(_width, ROW_SEGMENTS, segment + 1) * 3;
+			rowMax[segment] = reduceBytes(row + begin, columnBytes + begin, end - begin);
+		}
+	}
+
+	for (int segment = 0; segment < COLUMN_SEGMENTS; ++segment)
+	{
+		const uint8_t* columnBytes = &_columnBytes[static_cast<size_t>(segment) * rowBytes];
+		uint8_t* columnMax = &_columns[static_cast<size_t>(segment) * _width];
+		for (int x = 0; x < _width; ++x)
+		{
+			columnMax[x] = qMax(columnBytes[x * 3], qMax(columnBytes[x * 3 + 1], columnBytes[x * 3 + 2]));
+		}
+	}
+}
+
 BlackBorderDetector::BlackBorderDetector(double threshold)
 	: _blackborderThreshold(calculateThreshold(threshold))
 {
@@ -18,6 +18,7 @@ BlackBorderProcessor::BlackBorderProcessor(Hyperion* hyperion, QObject* parent)
 	, _blurRemoveCnt(1)
 	, _detectionMode("default")
 	, _detector(nullptr)
+	, _detectOnProxy(false)
 	, _currentBorder({true, -1, -1})
 	, _previousDetectedBorder({true, -1, -1})
 	, _consistentCnt(0)
@@ -61,6 +62,7 @@ void BlackBorderProcessor::handleSettingsUpdate(settings::type type, const QJson
 			_maxInconsistentCnt = obj["maxInconsistentCnt"].toInt(10);
 			_blurRemoveCnt = obj["blurRemoveCnt"].toInt(1);
 			_detectionMode = obj["mode"].toString("default");
+			_detectOnProxy = obj["detectOnProxy"].toBool(false);
 			const double newThreshold = obj["threshold"].toDouble(5.0) / 100.0;
 
 			if (fabs(_oldThreshold - newThreshold) > std::numeric_limits<double>::epsilon())
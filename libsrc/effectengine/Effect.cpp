@@ -25,6 +25,7 @@ Effect::Effect(Hyperion *hyperion, int priority, int timeout, const QString &scr
 	, _imageData(imageData)
 	, _endTime(-1)
 	, _interupt(false)
+	, _hidden(false)
 	, _imageSize(hyperion->getLedGridSize())
 	, _image(_imageSize,QImage::Format_ARGB32_Premultiplied)
 {
@@ -54,6 +55,14 @@ bool Effect::isInterruptionRequested()
 	return _interupt || (!_isEndless && getRemaining() <= 0);
 }
 
+void Effect::waitWhileHidden()
+{
+	while (_hidden && !isInterruptionRequested())
+	{
+		msleep(HIDDEN_POLL_INTERVAL_MS);
+	}
+}
+
 int Effect::getRemaining() const
 {
 	// determine the timeout
@@ -32,6 +32,9 @@ EffectEngine::EffectEngine(Hyperion * hyperion)
 	connect(_hyperion, &Hyperion::channelCleared, this, &EffectEngine::channelCleared);
 	connect(_hyperion, &Hyperion::allChannelsCleared, this, &EffectEngine::allChannelsCleared);
 
+	// pause hidden effects
+	connect(_hyperion->getMuxerInstance(), &PriorityMuxer::visiblePriorityChanged, this, &EffectEngine::handleVisiblePriorityChange);
+
 	// get notifications about refreshed effect list
 	connect(_effectFileHandler, &EffectFileHandler::effectListChanged, this, &EffectEngine::handleUpdatedEffectList);
 
@@ -208,7 +211,9 @@ int EffectEngine::runEffectScript(const QString &script, const QString &name, co
 	// create the effect
 	Effect *effect = new Effect(_hyperion, priority, timeout, script, name, args, imageData);
 	connect(effect, &Effect::setInput, _hyperion, &Hyperion::setInput, Qt::QueuedConnection);
-	connect(effect, &Effect::setInputImage, _hyperion, &Hyperion::setInputImage, Qt::QueuedConnection);
+	connect(effect, &Effect::setInputImage, _hyperion, [imageSlots = _hyperion->getInputImageSlots()](int priority, const Image<ColorRgb>& image, int timeout_ms, bool clearEffect) {
+		Hyperion::postInputImage(imageSlots, priority, image, timeout_ms, clearEffect);
+	}, Qt::DirectConnection);
 	connect(effect, &QThread::finished, this, &EffectEngine::effectFinished);
 	connect(_hyperion, &Hyperion::finished, effect, &Effect::requestInterruption, Qt::DirectConnection);
 	_activeEffects.push_back(effect);
@@ -216,6 +221,7 @@ int EffectEngine::runEffectScript(const QString &script, const QString &name, co
 	// start the effect
 	Debug(_log, "Start the effect: name [%s]", QSTRING_CSTR(name));
 	_hyperion->registerInput(priority, hyperion::COMP_EFFECT, origin, name ,smoothCfg);
+	effect->setHidden(_hyperion->getCurrentPriority() < priority);
 	effect->start();
 
 	return 0;
@@ -243,6 +249,14 @@ void EffectEngine::allChannelsCleared()
 	}
 }
 
+void EffectEngine::handleVisiblePriorityChange(int priority)
+{
+	for (Effect * effect : _activeEffects)
+	{
+		effect->setHidden(priority < effect->getPriority());
+	}
+}
+
 void EffectEngine::effectFinished()
 {
 	Effect* effect = qobject_cast<Effect*>(sender());
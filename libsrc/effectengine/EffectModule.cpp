@@ -343,7 +343,14 @@ PyObject* EffectModule::wrapGetImage(PyObject *self, PyObject *args)
 
 PyObject* EffectModule::wrapAbort(PyObject *self, PyObject *)
 {
-	return Py_BuildValue("i", getEffect()->isInterruptionRequested() ? 1 : 0);
+	Effect* effect = getEffect();
+
+	// an effect hidden behind a higher priority pauses in its loop, other effects may run meanwhile
+	Py_BEGIN_ALLOW_THREADS;
+	effect->waitWhileHidden();
+	Py_END_ALLOW_THREADS;
+
+	return Py_BuildValue("i", effect->isInterruptionRequested() ? 1 : 0);
 }
 
 
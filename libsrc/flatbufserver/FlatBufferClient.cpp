@@ -118,6 +118,11 @@ void FlatBufferClient::registationRequired(int priority)
 	}
 }
 
+void FlatBufferClient::handleVisiblePriorityChange(int hyperionInd, int priority)
+{
+	_throttle.setVisiblePriority(hyperionInd, priority);
+}
+
 void FlatBufferClient::handleRegisterCommand(const hyperionnet::Register *regReq)
 {
 	if (regReq->priority() < 100 || regReq->priority() >= 200)
@@ -128,6 +133,7 @@ void FlatBufferClient::handleRegisterCommand(const hyperionnet::Register *regReq
 	}
 
 	_priority = regReq->priority();
+	_throttle.setPriority(_priority);
 	emit registerGlobalInput(_priority, hyperion::COMP_FLATBUFSERVER, regReq->origin()->c_str()+_clientAddress);
 
 	auto reply = hyperionnet::CreateReplyDirect(_builder, nullptr, -1, (_priority ? _priority : -1));
@@ -166,6 +172,13 @@ void FlatBufferClient::handleImageCommand(const hyperionnet::Image *image)
 			return;
 		}
 
+		// images hidden behind a higher priority are forwarded at the keep-alive rate only
+		if (!_throttle.isFrameDue(duration))
+		{
+			sendSuccessReply();
+			return;
+		}
+
 		// create ImageRgb
 		Image<ColorRgb> imageRGB(width, height);
 		if (channelCount == 3)
@@ -198,6 +211,7 @@ void FlatBufferClient::handleClearCommand(const hyperionnet::Clear *clear)
 	// Check if we are clearing ourselves.
 	if (priority == _priority) {
 		_priority = -1;
+		_throttle.setPriority(_priority);
 	}
 
 	emit clearGlobalInput(priority);
@@ -6,6 +6,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/ColorRgba.h>
 #include <utils/Components.h>
+#include <utils/InputThrottle.h>
 
 // flatbuffer FBS
 #include "hyperion_reply_generated.h"
@@ -70,6 +71,13 @@ public slots:
 	///
 	void registationRequired(int priority);
 
+	///
+	/// @brief Update the visible priority of an instance, images hidden behind a higher priority are throttled
+	/// @param hyperionInd  The instance index
+	/// @param priority     The visible priority, -1 when the instance stopped
+	///
+	void handleVisiblePriorityChange(int hyperionInd, int priority);
+
 	///
 	/// @brief close the socket and call disconnected()
 	///
@@ -146,6 +154,9 @@ private:
 	int _timeout;
 	int _priority;
 
+	/// Throttles the images, while they are hidden behind a higher priority on all instances
+	InputThrottle _throttle;
+
 	QByteArray _receiveBuffer;
 
 	// Flatbuffers builder
@@ -83,6 +83,7 @@ void FlatBufferServer::newConnection()
 				connect(client, &FlatBufferClient::setGlobalInputColor, GlobalSignals::getInstance(), &GlobalSignals::setGlobalColor);
 				connect(client, &FlatBufferClient::setBufferImage, GlobalSignals::getInstance(), &GlobalSignals::setBufferImage);
 				connect(GlobalSignals::getInstance(), &GlobalSignals::globalRegRequired, client, &FlatBufferClient::registationRequired);
+				connect(GlobalSignals::getInstance(), &GlobalSignals::visiblePriorityChanged, client, &FlatBufferClient::handleVisiblePriorityChange);
 				_openConnections.append(client);
 			}
 			else
@@ -307,6 +307,12 @@ bool AmlogicGrabber::setPixelDecimation(int pixelDecimation)
 			 _fbGrabber.setPixelDecimation( pixelDecimation));
 }
 
+void AmlogicGrabber::setPixelDecimationAveraging(bool averaging)
+{
+	Grabber::setPixelDecimationAveraging(averaging);
+	_fbGrabber.setPixelDecimationAveraging(averaging);
+}
+
 void AmlogicGrabber::setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom)
 {
 	Grabber::setCropping(cropLeft, cropRight, cropTop, cropBottom);
@@ -36,7 +36,11 @@ void AudioWrapper::action()
 
 void AudioWrapper::newFrame(const Image<ColorRgb>& image)
 {
-	emit systemImage(_grabberName, image);
+	// frames hidden behind a higher priority are forwarded at the keep-alive rate only
+	if (_throttle.isFrameDue())
+	{
+		emit systemImage(_grabberName, image);
+	}
 }
 
 void AudioWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
@@ -233,7 +233,9 @@ int QtGrabber::grabFrame(Image<ColorRgb>& image)
 			}
 			else
 			{
-				QImage imageFrame = originalPixmap.toImage().scaled(_calculatedWidth, _calculatedHeight).convertToFormat(QImage::Format_RGB888);
+				// smooth scaling averages the pixels reduced by the decimation
+				const Qt::TransformationMode mode = _pixelDecimationAveraging ? Qt::SmoothTransformation : Qt::FastTransformation;
+				QImage imageFrame = originalPixmap.toImage().scaled(_calculatedWidth, _calculatedHeight, Qt::IgnoreAspectRatio, mode).convertToFormat(QImage::Format_RGB888);
 				image.resize(static_cast<uint>(_calculatedWidth), static_cast<uint>(_calculatedHeight));
 
 				for (int y = 0; y < imageFrame.height(); y++)
@@ -1,21 +1,77 @@
 #include "grabber/EncoderThread.h"
 
+#include <utils/FrameDecoderStatistics.h>
+
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+// DMABUF synchronisation (Linux 4.6 and later)
+#if defined(__linux__) && defined(__has_include)
+	#if __has_include(<linux/dma-buf.h>)
+		#include <cerrno>
+		#include <sys/ioctl.h>
+		#include <linux/dma-buf.h>
+	#endif
+#endif
+
+#ifdef HAVE_TURBO_JPEG
+namespace {
+
+///
+/// Returns the denominator of the MJPEG scale factor (1/1, 1/2, 1/4 or 1/8) for the given pixel decimation.
+/// The largest one dividing the decimation is used, so the resampler decimates the rest exactly,
+/// otherwise the largest one not exceeding the decimation.
+///
+int mjpegScaleDenominator(int pixelDecimation)
+{
+	if (pixelDecimation <= 1)
+	{
+		return 1;
+	}
+
+	for (int denominator : {8, 4, 2})
+	{
+		if (pixelDecimation % denominator == 0)
+		{
+			return denominator;
+		}
+	}
+
+	for (int denominator : {8, 4, 2})
+	{
+		if (pixelDecimation > denominator)
+		{
+			return denominator;
+		}
+	}
+
+	return 1;
+}
+
+} // namespace
+#endif
 
 EncoderThread::EncoderThread()
-	: _localData(nullptr)
-	, _scalingFactorsCount(0)
+	: _frameData(nullptr)
+	, _dmabufFd(-1)
+	, _localData(nullptr)
+	, _localDataCapacity(0)
+	, _transformData(nullptr)
+	, _transformDataCapacity(0)
+	, _decodeData(nullptr)
+	, _decodeDataCapacity(0)
+	, _pixelDecimationAveraging(false)
 	, _doTransform(false)
+	, _metadata()
+	, _sequence(0)
 	,_imageResampler()
 	#ifdef HAVE_TURBO_JPEG
+	, _mjpegResampler()
 	, _tjInstance(nullptr)
-	, _scalingFactors(nullptr)
 	, _xform(nullptr)
 	#endif
 {
-#ifdef HAVE_TURBO_JPEG
-	_scalingFactors = tjGetScalingFactors(&_scalingFactorsCount);
-#endif
 }
 
 EncoderThread::~EncoderThread()
@@ -23,25 +79,74 @@ EncoderThread::~EncoderThread()
 #ifdef HAVE_TURBO_JPEG
 	if (_tjInstance)
 		tjDestroy(_tjInstance);
+	delete _xform;
 #endif
 
-	if (_localData != nullptr)
+	release(_localData, _localDataCapacity);
+	release(_transformData, _transformDataCapacity);
+	release(_decodeData, _decodeDataCapacity);
+}
+
+bool EncoderThread::reserve(uint8_t*& buffer, size_t& capacity, size_t size)
+{
+	if (buffer != nullptr && capacity >= size)
 	{
+		return true;
+	}
+
+	release(buffer, capacity);
 #ifdef HAVE_TURBO_JPEG
-		tjFree(_localData);
+	// Allocated by TurboJPEG, as it is handed to the MJPEG transformation as output buffer
+	buffer = static_cast<uint8_t*>(tjAlloc(static_cast<int>(size + 1)));
 #else
-		delete[] _localData;
+	buffer = new uint8_t[size + 1];
 #endif
-		_localData = nullptr;
+	capacity = (buffer != nullptr) ? size + 1 : 0;
+	return buffer != nullptr;
+}
+
+void EncoderThread::release(uint8_t*& buffer, size_t& capacity)
+{
+	if (buffer != nullptr)
+	{
+#ifdef HAVE_TURBO_JPEG
+		tjFree(buffer);
+#else
+		delete[] buffer;
+#endif
+		buffer = nullptr;
+	}
+	capacity = 0;
+}
+
+void EncoderThread::syncDmabuf(int dmabufFd, bool start)
+{
+#ifdef DMA_BUF_IOCTL_SYNC
+	if (dmabufFd >= 0)
+	{
+		struct dma_buf_sync sync;
+		sync.flags = (start ? DMA_BUF_SYNC_START : DMA_BUF_SYNC_END) | DMA_BUF_SYNC_READ;
+
+		while (ioctl(dmabufFd, DMA_BUF_IOCTL_SYNC, &sync) == -1 && (errno == EINTR || errno == EAGAIN))
+		{
+		}
 	}
+#else
+	Q_UNUSED(dmabufFd);
+	Q_UNUSED(start);
+#endif
 }
 
 void EncoderThread::setup(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool pixelDecimationAveraging,
+		bool borrowData, int dmabufFd, const ImageMetadata& metadata, quint64 sequence)
 {
+	_busy = true;
+	_metadata = metadata;
+	_sequence = sequence;
 	_lineLength = lineLength;
 	_pixelFormat = pixelFormat;
 	_size = static_cast<unsigned long>(size);
@@ -54,9 +159,14 @@ void EncoderThread::setup(
 	_flipMode = flipMode;
 	_videoMode = videoMode;
 	_pixelDecimation = pixelDecimation;
+	_pixelDecimationAveraging = pixelDecimationAveraging;
 
 	bool needTransform {false};
 
+#ifdef MJPEG_PARTIAL_DECOMPRESSION
+	// Cropping and 3D mode are applied by decompressing the cropping region only
+	needTransform = _flipMode != FlipMode::NO_CHANGE;
+#else
 	if (_cropLeft > 0 || _cropTop > 0 || _cropBottom > 0 || _cropRight > 0 ||
 		_flipMode != FlipMode::NO_CHANGE ||
 		_videoMode !=  VideoMode::VIDEO_2D)
@@ -67,6 +177,7 @@ void EncoderThread::setup(
 	{
 		needTransform = false;
 	}
+#endif
 
 #ifdef HAVE_TURBO_JPEG
 	if (_doTransform != needTransform )
@@ -85,39 +196,40 @@ void EncoderThread::setup(
 	_imageResampler.setCropping(_cropLeft, _cropRight, _cropTop, _cropBottom);
 	_imageResampler.setHorizontalPixelDecimation(_pixelDecimation);
 	_imageResampler.setVerticalPixelDecimation(_pixelDecimation);
+	_imageResampler.setPixelDecimationAveraging(pixelDecimationAveraging);
 
-#ifdef HAVE_TURBO_JPEG
-	if (_localData != nullptr)
+	_dmabufFd = -1;
+	if (borrowData)
 	{
-		tjFree(_localData);
-		_localData = nullptr;
+		_frameData = sharedData;
+		_dmabufFd = dmabufFd;
 	}
-	_localData = static_cast<uint8_t*>(tjAlloc(size + 1));
-#else
-	if (_localData != nullptr)
+	else if (reserve(_localData, _localDataCapacity, _size))
 	{
-		delete[] _localData;
-		_localData = nullptr;
+		syncDmabuf(dmabufFd, true);
+		memcpy(_localData, sharedData, _size);
+		syncDmabuf(dmabufFd, false);
+		_frameData = _localData;
 	}
-
-	_localData = new uint8_t[size];
-#endif
-
-	if (_localData != nullptr)
+	else
 	{
-		memcpy(_localData, sharedData, static_cast<size_t>(size));
+		_frameData = nullptr;
 	}
 }
 
 void EncoderThread::process()
 {
-	_busy = true;
-	if (_width > 0 && _height > 0)
+	Image<ColorRgb> image;
+	bool decoded {false};
+
+	syncDmabuf(_dmabufFd, true);
+
+	if (_frameData != nullptr && _width > 0 && _height > 0)
 	{
 #ifdef HAVE_TURBO_JPEG
 		if (_pixelFormat == PixelFormat::MJPEG)
 		{
-			processImageMjpeg();
+			decoded = processImageMjpeg(image);
 		}
 		else
 #endif
@@ -134,9 +246,8 @@ void EncoderThread::process()
 					_imageResampler.setFlipMode(FlipMode::VERTICAL);
 			}
 
-			Image<ColorRgb> image = Image<ColorRgb>();
 			_imageResampler.processImage(
-				_localData,
+				_frameData,
 				_width,
 				_height,
 				_lineLength,
@@ -147,16 +258,30 @@ void EncoderThread::process()
 #endif
 				image
 			);
-
-			emit newFrame(image);
+			decoded = true;
 		}
 	}
+
+	syncDmabuf(_dmabufFd, false);
+
+	if (decoded)
+	{
+		image.setMetadata(_metadata);
+	}
+
+	// A borrowed buffer is handed back to the device after processing
+	_frameData = nullptr;
+	_dmabufFd = -1;
+	emit frameProcessed(_sequence, image, decoded);
 	_busy = false;
 }
 
 #ifdef HAVE_TURBO_JPEG
-void EncoderThread::processImageMjpeg()
+bool EncoderThread::processImageMjpeg(Image<ColorRgb>& image)
 {
+	QElapsedTimer decodeTimer;
+	decodeTimer.start();
+
 	int inSubsamp {0};
 	int inColorspace {0};
 
@@ -165,14 +290,15 @@ void EncoderThread::processImageMjpeg()
 		if (!_tjInstance)
 		{
 			_tjInstance = tjInitTransform();
-			_xform = new tjtransform();
+			if (_xform == nullptr)
+				_xform = new tjtransform();
 		}
 
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("_doTransform - tjDecompressHeader3"))
 			{
-				return;
+				return false;
 			}
 		}
 
@@ -246,19 +372,27 @@ void EncoderThread::processImageMjpeg()
 			break;
 		}
 
-		unsigned char *dstBuf = nullptr;  /* Dynamically allocate the JPEG buffer */
-		unsigned long dstSize = 0;
+		// The output buffer is kept and sized for the largest possible JPEG image of the transformed size,
+		// so TurboJPEG never has to reallocate it
+		const unsigned long bufferSize = tjBufSize(transformedWidth, transformedHeight, inSubsamp);
+		if (bufferSize == static_cast<unsigned long>(-1) || !reserve(_transformData, _transformDataCapacity, bufferSize))
+		{
+			return false;
+		}
+
+		unsigned char *dstBuf = _transformData;
+		unsigned long dstSize = static_cast<unsigned long>(_transformDataCapacity);
 
-		if(tjTransform(_tjInstance, _localData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) < 0 )
+		const int result = tjTransform(_tjInstance, _frameData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE | TJFLAG_NOREALLOC);
+		if (result < 0)
 		{
 			if (onError("_doTransform - tjTransform"))
 			{
-				return;
+				return false;
 			}
 		}
 
-		tjFree(_localData);
-		_localData = dstBuf;
+		_frameData = _transformData;
 		_size = dstSize;
 	}
 	else
@@ -271,66 +405,144 @@ void EncoderThread::processImageMjpeg()
 
 	if (_doTransform)
 	{
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader3"))
 			{
-				return;
+				return false;
 			}
 		}
 	}
 	else
 	{
-		if (tjDecompressHeader2(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp) < 0)
+		if (tjDecompressHeader2(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader2"))
 			{
-				return;
+				return false;
 			}
 		}
 	}
 
-	if(_scalingFactors != nullptr && _pixelDecimation > 1)
+	// Decode directly at 1/2, 1/4 or 1/8 of the size, which skips most of the IDCT work.
+	// A remaining decimation (e.g. 2 for a decimation of 16) is done by the resampler.
+	const int scaleDenominator = mjpegScaleDenominator(_pixelDecimation);
+	const int remainingDecimation = qMax((_pixelDecimation + scaleDenominator / 2) / scaleDenominator, 1);
+	const tjscalingfactor scalingFactor {1, scaleDenominator};
+
+	int decodedWidth = TJSCALED(_width, scalingFactor);
+	int decodedHeight = TJSCALED(_height, scalingFactor);
+	int resampleCropLeft {0};
+
+#ifdef MJPEG_PARTIAL_DECOMPRESSION
+	// Decompress the cropping region (and the 3D half) only, in scaled coordinates.
+	// Its left boundary has to be aligned to an iMCU, the remaining columns are cropped by the resampler.
+	tjregion croppingRegion {0, 0, 0, 0};
+	if (!_doTransform && inSubsamp >= 0)
 	{
-		//Scaling factors will not do map 1:1 to pixel decimation, but do a best match
-		//In case perfect pixel decimation is required, code needs to make use of a interim image.
+		int frameWidth {decodedWidth};
+		int frameHeight {decodedHeight};
 
-		bool scaleingFactorFound {false};
-		for (int i = 0; i < _scalingFactorsCount ; i++)
+		switch (_videoMode)
 		{
-			const int tempWidth = TJSCALED(_width, _scalingFactors[i]);
-			const int tempHeight = TJSCALED(_height, _scalingFactors[i]);
+		case VideoMode::VIDEO_3DSBS:
+			frameWidth = frameWidth >> 1;
+			_cropLeft = _cropLeft >> 1;
+			_cropRight = _cropRight >> 1;
+			break;
+		case VideoMode::VIDEO_3DTAB:
+			frameHeight = frameHeight >> 1;
+			_cropTop = _cropTop >> 1;
+			_cropBottom = _cropBottom >> 1;
+			break;
+		default:
+			break;
+		}
 
-			if (tempWidth <= _width/_pixelDecimation && tempHeight <= _height/_pixelDecimation)
-			{
-				_width = tempWidth;
-				_height = tempHeight;
-				scaleingFactorFound = true;
-				break;
-			}
+		int left = _cropLeft / scaleDenominator;
+		int right = frameWidth - _cropRight / scaleDenominator;
+		int top = _cropTop / scaleDenominator;
+		int bottom = frameHeight - _cropBottom / scaleDenominator;
+
+		if (right <= left)
+		{
+			left = 0;
+			right = frameWidth;
+		}
+		if (bottom <= top)
+		{
+			top = 0;
+			bottom = frameHeight;
 		}
 
-		if (!scaleingFactorFound)
+		const int mcuWidth = TJSCALED(tjMCUWidth[inSubsamp], scalingFactor);
+		const int alignedLeft = left - left % mcuWidth;
+
+		if (alignedLeft > 0 || top > 0 || right < decodedWidth || bottom < decodedHeight)
 		{
-			//Set to smallest scaling factor
-			_width = TJSCALED(_width, _scalingFactors[_scalingFactorsCount-1]);
-			_height = TJSCALED(_height, _scalingFactors[_scalingFactorsCount-1]);
+			croppingRegion = tjregion {alignedLeft, top, right - alignedLeft, bottom - top};
+			resampleCropLeft = left - alignedLeft;
+			decodedWidth = croppingRegion.w;
+			decodedHeight = croppingRegion.h;
 		}
 	}
+#endif
 
-	Image<ColorRgb> srcImage(static_cast<unsigned>(_width), static_cast<unsigned>(_height));
+	const bool resample = remainingDecimation > 1 || resampleCropLeft > 0;
+	unsigned char* decoded {nullptr};
+	if (resample)
+	{
+		if (!reserve(_decodeData, _decodeDataCapacity, static_cast<size_t>(decodedWidth) * decodedHeight * 3))
+		{
+			return false;
+		}
+		decoded = _decodeData;
+	}
+	else
+	{
+		image.reset(static_cast<unsigned>(decodedWidth), static_cast<unsigned>(decodedHeight));
+		decoded = reinterpret_cast<unsigned char*>(image.memptr());
+	}
 
-	if (tjDecompress2(_tjInstance, _localData , _size,
-					  reinterpret_cast<unsigned char*>(srcImage.memptr()), _width, 0, _height,
-					  TJPF_RGB, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE)
+	// The resampler reads BGR24, which it converts to RGB on the way
+	const int pixelFormat = resample ? TJPF_BGR : TJPF_RGB;
+
+#ifdef MJPEG_PARTIAL_DECOMPRESSION
+	tj3Set(_tjInstance, TJPARAM_FASTDCT, 1);
+	tj3Set(_tjInstance, TJPARAM_FASTUPSAMPLE, 1);
+	if (tj3SetScalingFactor(_tjInstance, scalingFactor) < 0 ||
+		tj3SetCroppingRegion(_tjInstance, croppingRegion) < 0 ||
+		tj3Decompress8(_tjInstance, _frameData, _size, decoded, 0, pixelFormat) < 0)
+	{
+		if (onError("get final image - tj3Decompress8"))
+		{
+			return false;
+		}
+	}
+#else
+	if (tjDecompress2(_tjInstance, _frameData , _size,
+					  decoded, decodedWidth, 0, decodedHeight,
+					  pixelFormat, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE)
 		< 0)
 	{
 		if (onError("get final image - tjDecompress2"))
 		{
-			return;
+			return false;
 		}
 	}
-	emit newFrame(srcImage);
+#endif
+
+	if (resample)
+	{
+		_mjpegResampler.setCropping(resampleCropLeft, 0, 0, 0);
+		_mjpegResampler.setHorizontalPixelDecimation(remainingDecimation);
+		_mjpegResampler.setVerticalPixelDecimation(remainingDecimation);
+		_mjpegResampler.setPixelDecimationAveraging(_pixelDecimationAveraging);
+		_mjpegResampler.processImage(decoded, decodedWidth, decodedHeight, decodedWidth * 3, PixelFormat::BGR24, image);
+	}
+
+	FrameDecoderStatistics::getInstance().countMjpegDecoded(scaleDenominator, decodeTimer.nsecsElapsed());
+	return true;
 }
 #endif
 
@@ -351,3 +563,139 @@ bool EncoderThread::onError(const QString context) const
 return treatAsError;
 }
 #endif
+
+void EncoderThreadManager::start()
+{
+	if (_threads != nullptr)
+		for (unsigned long  i = 0; i < _threadCount; i++)
+			connect(_threads[i]->thread(), &EncoderThread::frameProcessed, this, &EncoderThreadManager::onFrameProcessed);
+
+	FrameDecoderStatistics::getInstance().setThreads(static_cast<quint32>(_threadCount));
+	_loggedStatistics = FrameDecoderStatistics::getInstance().statistics();
+	_decodeTimeLogTimer.start();
+}
+
+void EncoderThreadManager::stop()
+{
+	if (_threads != nullptr)
+	{
+		for(unsigned long  i = 0; i < _threadCount; i++)
+			disconnect(_threads[i]->thread(), nullptr, nullptr, nullptr);
+
+		for(unsigned long  i = 0; i < _threadCount; i++)
+			while (_threads[i]->isBusy())
+				QThread::msleep(1);
+	}
+
+	// Frames processed before are not delivered any more
+	QMutexLocker lock(&_sequenceMutex);
+	_nextSequence = _sequence + 1;
+	_heldFrames.clear();
+}
+
+quint64 EncoderThreadManager::process(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool pixelDecimationAveraging,
+		bool borrowData, int dmabufFd, const ImageMetadata& metadata)
+{
+	for (unsigned long i = 0; i < _threadCount; i++)
+	{
+		if (!_threads[i]->isBusy())
+		{
+			quint64 sequence {0};
+			{
+				QMutexLocker lock(&_sequenceMutex);
+				sequence = ++_sequence;
+			}
+
+			_threads[i]->setup(pixelFormat, sharedData,
+				size, width, height, lineLength,
+				cropLeft, cropTop, cropBottom, cropRight,
+				videoMode, flipMode, pixelDecimation, pixelDecimationAveraging,
+				borrowData, dmabufFd, metadata, sequence);
+			_threads[i]->process();
+			return sequence;
+		}
+	}
+
+	FrameDecoderStatistics::getInstance().countDropped();
+	return 0;
+}
+
+void EncoderThreadManager::onFrameProcessed(quint64 sequence, const Image<ColorRgb>& image, bool decoded)
+{
+	emit frameReleased(sequence);
+
+	FrameDecoderStatistics& statistics = FrameDecoderStatistics::getInstance();
+	statistics.countDecoded(decoded);
+
+	if (_decodeTimeLogTimer.isValid() && _decodeTimeLogTimer.elapsed() >= DECODE_TIME_LOG_INTERVAL)
+	{
+		logDecodeTimes();
+		_decodeTimeLogTimer.restart();
+	}
+
+	if (sequence < _nextSequence)
+	{
+		// Overtaken by a later frame or processed before stop()
+		statistics.countDropped();
+		return;
+	}
+
+	if (sequence > _nextSequence)
+	{
+		statistics.countReordered();
+
+		if (!_latestFrameWins)
+		{
+			_heldFrames.emplace(sequence, std::make_pair(image, decoded));
+			return;
+		}
+
+		// Earlier frames still held back, if the policy was changed, are dropped as well
+		for (auto held = _heldFrames.begin(); held != _heldFrames.end() && held->first < sequence; held = _heldFrames.erase(held))
+		{
+			statistics.countDropped();
+		}
+	}
+
+	if (decoded)
+	{
+		emit newFrame(image);
+	}
+	++sequence;
+
+	// Deliver the frames held back for this one
+	for (auto held = _heldFrames.begin(); held != _heldFrames.end() && held->first == sequence; held = _heldFrames.erase(held))
+	{
+		if (held->second.second)
+		{
+			emit newFrame(held->second.first);
+		}
+		++sequence;
+	}
+
+	_nextSequence = sequence;
+}
+
+void EncoderThreadManager::logDecodeTimes()
+{
+	const FrameDecoderStatistics::Statistics statistics = FrameDecoderStatistics::getInstance().statistics();
+
+	for (int scale = 0; scale < FrameDecoderStatistics::MJPEG_SCALES; ++scale)
+	{
+		const FrameDecoderStatistics::ScaleStatistics interval {
+			statistics.mjpeg[scale].frames - _loggedStatistics.mjpeg[scale].frames,
+			statistics.mjpeg[scale].nsecs - _loggedStatistics.mjpeg[scale].nsecs
+		};
+
+		if (interval.frames > 0)
+		{
+			Debug(_log, "MJPEG decoding at scale 1/%d: %.2f ms/frame (%llu frames)", 1 << scale, interval.averageMs(), static_cast<unsigned long long>(interval.frames));
+		}
+	}
+
+	_loggedStatistics = statistics;
+}
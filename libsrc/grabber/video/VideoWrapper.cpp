@@ -82,6 +82,7 @@ void VideoWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument
 
 			// Image size decimation
 			_grabber.setPixelDecimation(obj["sizeDecimation"].toInt(8));
+			_grabber.setPixelDecimationAveraging(obj["sizeDecimationAveraging"].toBool(false));
 
 			// Flip mode
 			_grabber.setFlipMode(parseFlipMode(obj["flip"].toString("NO_CHANGE")));
@@ -108,6 +109,9 @@ void VideoWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument
 			// Software frame skipping
 			_grabber.setFpsSoftwareDecimation(obj["fpsSoftwareDecimation"].toInt(1));
 
+			// Frame delivery order of the decoding threads
+			_grabber.setLatestFrameWins(obj["latestFrameWins"].toBool(false));
+
 			// Signal detection
 			_grabber.setSignalDetectionEnable(obj["signalDetection"].toBool(true));
 			_grabber.setSignalDetectionOffset(
@@ -136,7 +140,11 @@ void VideoWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument
 
 void VideoWrapper::newFrame(const Image<ColorRgb> &image)
 {
-	emit systemImage(_grabberName, image);
+	// frames hidden behind a higher priority are forwarded at the keep-alive rate only
+	if (_throttle.isFrameDue())
+	{
+		emit systemImage(_grabberName, image);
+	}
 }
 
 void VideoWrapper::readError(const char* err)
@@ -1,6 +1,8 @@
 #include "MFSourceReaderCB.h"
 #include "grabber/MFGrabber.h"
 
+#include <utils/LatencyStatistics.h>
+
 // Constants
 namespace { const bool verbose = false; }
 
@@ -45,6 +47,7 @@ MFGrabber::MFGrabber()
 	, _noSignalDetected(false)
 	, _initialized(false)
 	, _reload(false)
+	, _latestFrameWins(false)
 	, _x_frac_min(0.25)
 	, _y_frac_min(0.25)
 	, _x_frac_max(0.75)
@@ -83,7 +86,7 @@ bool MFGrabber::prepare()
 			_sourceReaderCB = new SourceReaderCB(this);
 
 		if (!_threadManager)
-			_threadManager = new EncoderThreadManager(this);
+			_threadManager = new EncoderThreadManager(_log, this);
 
 		return (_sourceReaderCB != nullptr && _threadManager != nullptr);
 	}
@@ -98,6 +101,7 @@ bool MFGrabber::start()
 		if (init())
 		{
 			connect(_threadManager, &EncoderThreadManager::newFrame, this, &MFGrabber::newThreadFrame);
+			_threadManager->setLatestFrameWins(_latestFrameWins);
 			_threadManager->start();
 			DebugIf(verbose, _log, "Decoding threads: %d", _threadManager->_threadCount);
 
@@ -537,15 +541,11 @@ void MFGrabber::process_image(const void *frameImageBuffer, int size)
 		Error(_log, "Frame too small: %d != %d", size, _frameByteSize);
 	else if (_threadManager != nullptr)
 	{
-		for (unsigned long i = 0; i < _threadManager->_threadCount; i++)
-		{
-			if (!_threadManager->_threads[i]->isBusy())
-			{
-				_threadManager->_threads[i]->setup(_pixelFormat, (uint8_t*)frameImageBuffer, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation);
-				_threadManager->_threads[i]->process();
-				break;
-			}
-		}
+		// Frames are numbered as received from the device, frames not delivered leave a gap
+		const ImageMetadata metadata(LatencyStatistics::now(), static_cast<quint64>(processFrameIndex) + 1, ImageMetadata::sourceIdOf(_currentDeviceName));
+
+		// The media buffer is unlocked when this returns, so the frame is copied for decoding
+		_threadManager->process(_pixelFormat, (uint8_t*)frameImageBuffer, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, _pixelDecimationAveraging, false, -1, metadata);
 	}
 }
 
@@ -695,6 +695,17 @@ void MFGrabber::setSignalDetectionEnable(bool enable)
 	}
 }
 
+void MFGrabber::setLatestFrameWins(bool enable)
+{
+	if (_latestFrameWins != enable)
+	{
+		_latestFrameWins = enable;
+		if (_threadManager != nullptr)
+			_threadManager->setLatestFrameWins(enable);
+		Debug(_log, "Latest frame wins: %s", enable ? "enabled" : "disabled");
+	}
+}
+
 bool MFGrabber::reload(bool force)
 {
 	if (_reload || force)
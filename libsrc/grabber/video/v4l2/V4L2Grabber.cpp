@@ -18,6 +18,7 @@
 
 #include <hyperion/Hyperion.h>
 #include <hyperion/HyperionIManager.h>
+#include <utils/LatencyStatistics.h>
 
 #include <QDirIterator>
 #include <QFileInfo>
@@ -34,6 +35,21 @@
 // Constants
 namespace { const bool verbose = false; }
 
+///
+/// Returns the capture time of a dequeued buffer on the clock of LatencyStatistics::now(),
+/// which is the driver's timestamp, if it is taken from the monotonic clock, otherwise the current time
+///
+static qint64 bufferCaptureTime(const struct v4l2_buffer& buf)
+{
+	if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC &&
+		(buf.timestamp.tv_sec != 0 || buf.timestamp.tv_usec != 0))
+	{
+		return static_cast<qint64>(buf.timestamp.tv_sec) * 1000000000 + static_cast<qint64>(buf.timestamp.tv_usec) * 1000;
+	}
+
+	return LatencyStatistics::now();
+}
+
 // Need more video properties? Visit https://www.kernel.org/doc/html/v4.14/media/uapi/v4l/control.html
 using ControlIDPropertyMap = QMap<unsigned int, QString>;
 inline QMap<unsigned int, QString> initControlIDPropertyMap()
@@ -72,6 +88,7 @@ V4L2Grabber::V4L2Grabber()
 	, _threadManager(nullptr)
 	, _ioMethod(IO_METHOD_MMAP)
 	, _fileDescriptor(-1)
+	, _latestFrameWins(false)
 	, _pixelFormat(PixelFormat::NO_CHANGE)
 	, _pixelFormatConfig(PixelFormat::NO_CHANGE)
 	, _lineLength(-1)
@@ -110,7 +127,7 @@ V4L2Grabber::~V4L2Grabber()
 bool V4L2Grabber::prepare()
 {
 	if (!_threadManager)
-		_threadManager = new EncoderThreadManager(this);
+		_threadManager = new EncoderThreadManager(_log, this);
 
 	return (_threadManager != nullptr);
 }
@@ -208,6 +225,8 @@ bool V4L2Grabber::start()
 		if (init() && _streamNotifier != nullptr && !_streamNotifier->isEnabled())
 		{
 			connect(_threadManager, &EncoderThreadManager::newFrame, this, &V4L2Grabber::newThreadFrame);
+			connect(_threadManager, &EncoderThreadManager::frameReleased, this, &V4L2Grabber::releaseFrameBuffer);
+			_threadManager->setLatestFrameWins(_latestFrameWins);
 			_threadManager->start();
 			DebugIf(verbose, _log, "Decoding threads: %u", _threadManager->_threadCount);
 
@@ -233,6 +252,8 @@ void V4L2Grabber::stop()
 		_threadManager->stop();
 		disconnect(_threadManager, nullptr, nullptr, nullptr);
 		stop_capturing();
+		// Stopping the stream dequeues all buffers
+		_borrowedBuffers.clear();
 		_streamNotifier->setEnabled(false);
 		uninit_device();
 		close_device();
@@ -293,6 +314,7 @@ void V4L2Grabber::init_read(unsigned int buffer_size)
 
 	_buffers[0].length = buffer_size;
 	_buffers[0].start = malloc(buffer_size);
+	_buffers[0].dmabufFd = -1;
 
 	if (!_buffers[0].start)
 	{
@@ -333,6 +355,10 @@ void V4L2Grabber::init_mmap()
 
 	_buffers.resize(req.count);
 
+	// Export the buffers as DMABUF and map them read-only, if the driver supports it.
+	// The decoding threads then synchronise their access with the device through the DMABUF.
+	bool exportBuffers {true};
+
 	for (size_t n_buffers = 0; n_buffers < req.count; ++n_buffers)
 	{
 		struct v4l2_buffer buf;
@@ -350,12 +376,48 @@ void V4L2Grabber::init_mmap()
 		}
 
 		_buffers[n_buffers].length = buf.length;
-		_buffers[n_buffers].start = mmap(NULL /* start anywhere */,
-						buf.length,
-						PROT_READ | PROT_WRITE /* required */,
-						MAP_SHARED /* recommended */,
-						_fileDescriptor, buf.m.offset
-					);
+		_buffers[n_buffers].start = MAP_FAILED;
+		_buffers[n_buffers].dmabufFd = -1;
+
+		if (exportBuffers)
+		{
+			struct v4l2_exportbuffer expbuf;
+
+			CLEAR(expbuf);
+			expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+			expbuf.index = n_buffers;
+			expbuf.flags = O_RDONLY | O_CLOEXEC;
+
+			if (-1 == xioctl(VIDIOC_EXPBUF, &expbuf))
+			{
+				Debug(_log, "Buffers cannot be exported as DMABUF (%s), using memory mapped buffers", strerror(errno));
+				exportBuffers = false;
+			}
+			else
+			{
+				_buffers[n_buffers].start = mmap(NULL, buf.length, PROT_READ, MAP_SHARED, expbuf.fd, 0);
+				if (MAP_FAILED == _buffers[n_buffers].start)
+				{
+					Debug(_log, "Exported DMABUF cannot be mapped (%s), using memory mapped buffers", strerror(errno));
+					close(expbuf.fd);
+					exportBuffers = false;
+				}
+				else
+				{
+					_buffers[n_buffers].dmabufFd = expbuf.fd;
+				}
+			}
+		}
+
+		if (MAP_FAILED == _buffers[n_buffers].start)
+		{
+			_buffers[n_buffers].start = mmap(NULL /* start anywhere */,
+							buf.length,
+							PROT_READ | PROT_WRITE /* required */,
+							MAP_SHARED /* recommended */,
+							_fileDescriptor, buf.m.offset
+						);
+		}
 
 		if (MAP_FAILED == _buffers[n_buffers].start)
 		{
@@ -395,6 +457,7 @@ void V4L2Grabber::init_userp(unsigned int buffer_size)
 	{
 		_buffers[n_buffers].length = buffer_size;
 		_buffers[n_buffers].start = malloc(buffer_size);
+		_buffers[n_buffers].dmabufFd = -1;
 
 		if (!_buffers[n_buffers].start)
 		{
@@ -778,11 +841,19 @@ void V4L2Grabber::uninit_device()
 		case IO_METHOD_MMAP:
 		{
 			for (size_t i = 0; i < _buffers.size(); ++i)
+			{
 				if (-1 == munmap(_buffers[i].start, _buffers[i].length))
 				{
 					throw_errno_exception("munmap");
 					return;
 				}
+
+				if (_buffers[i].dmabufFd >= 0)
+				{
+					close(_buffers[i].dmabufFd);
+					_buffers[i].dmabufFd = -1;
+				}
+			}
 		}
 		break;
 
@@ -906,7 +977,8 @@ int V4L2Grabber::read_frame()
 					}
 				}
 
-				rc = process_image(_buffers[0].start, size);
+				// The buffer is read into again by the next frame, so it is copied
+				rc = process_image(_buffers[0].start, size, false, -1, LatencyStatistics::now()) != 0;
 			}
 			break;
 
@@ -937,9 +1009,17 @@ int V4L2Grabber::read_frame()
 
 				assert(buf.index < _buffers.size());
 
-				rc = process_image(_buffers[buf.index].start, buf.bytesused);
+				// The buffer is decoded in place and re-queued when the frame was processed,
+				// as long as the driver keeps at least one other buffer to capture into
+				const bool borrowData = _borrowedBuffers.size() + 2 <= static_cast<int>(_buffers.size());
+				const quint64 sequence = process_image(_buffers[buf.index].start, buf.bytesused, borrowData, _buffers[buf.index].dmabufFd, bufferCaptureTime(buf));
+				rc = sequence != 0;
 
-				if (-1 == xioctl(VIDIOC_QBUF, &buf))
+				if (rc && borrowData)
+				{
+					_borrowedBuffers.insert(sequence, buf.index);
+				}
+				else if (-1 == xioctl(VIDIOC_QBUF, &buf))
 				{
 					throw_errno_exception("VIDIOC_QBUF");
 					return 0;
@@ -972,17 +1052,22 @@ int V4L2Grabber::read_frame()
 					}
 				}
 
-				for (size_t i = 0; i < _buffers.size(); ++i)
+				size_t index = 0;
+				while (index < _buffers.size() && (buf.m.userptr != (unsigned long)_buffers[index].start || buf.length != _buffers[index].length))
 				{
-					if (buf.m.userptr == (unsigned long)_buffers[i].start && buf.length == _buffers[i].length)
-					{
-						break;
-					}
+					++index;
 				}
 
-				rc = process_image((void *)buf.m.userptr, buf.bytesused);
+				// As for memory mapped buffers, the buffer is re-queued when the frame was processed
+				const bool borrowData = index < _buffers.size() && _borrowedBuffers.size() + 2 <= static_cast<int>(_buffers.size());
+				const quint64 sequence = process_image((void *)buf.m.userptr, buf.bytesused, borrowData, -1, bufferCaptureTime(buf));
+				rc = sequence != 0;
 
-				if (!rc && -1 == xioctl(VIDIOC_QBUF, &buf))
+				if (rc && borrowData)
+				{
+					_borrowedBuffers.insert(sequence, static_cast<unsigned int>(index));
+				}
+				else if (-1 == xioctl(VIDIOC_QBUF, &buf))
 				{
 					throw_errno_exception("VIDIOC_QBUF");
 					return 0;
@@ -1000,13 +1085,14 @@ int V4L2Grabber::read_frame()
 	return rc ? 1 : 0;
 }
 
-bool V4L2Grabber::process_image(const void *p, int size)
+quint64 V4L2Grabber::process_image(const void *p, int size, bool borrowData, int dmabufFd, qint64 captureTime)
 {
-	int processFrameIndex = _currentFrame++, result = false;
+	int processFrameIndex = _currentFrame++;
+	quint64 sequence = 0;
 
 	// frame skipping
 	if ((processFrameIndex % (_fpsSoftwareDecimation + 1) != 0) && (_fpsSoftwareDecimation > 0))
-		return result;
+		return sequence;
 
 #ifdef HAVE_TURBO_JPEG
 	if (size < _frameByteSize && _pixelFormat != PixelFormat::MJPEG)
@@ -1018,19 +1104,48 @@ bool V4L2Grabber::process_image(const void *p, int size)
 	}
 	else if (_threadManager != nullptr)
 	{
-		for (int i = 0; i < _threadManager->_threadCount; i++)
-		{
-			if (!_threadManager->_threads[i]->isBusy())
-			{
-				_threadManager->_threads[i]->setup(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation);
-				_threadManager->_threads[i]->process();
-				result = true;
-				break;
-			}
-		}
+		// Frames are numbered as received from the device, frames not delivered leave a gap
+		const ImageMetadata metadata(captureTime, static_cast<quint64>(processFrameIndex) + 1, ImageMetadata::sourceIdOf(_currentDevicePath));
+		sequence = _threadManager->process(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, _pixelDecimationAveraging, borrowData, dmabufFd, metadata);
+	}
+
+	return sequence;
+}
+
+void V4L2Grabber::queue_buffer(unsigned int index)
+{
+	struct v4l2_buffer buf;
+
+	CLEAR(buf);
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.index = index;
+
+	if (_ioMethod == IO_METHOD_USERPTR)
+	{
+		buf.memory = V4L2_MEMORY_USERPTR;
+		buf.m.userptr = (unsigned long)_buffers[index].start;
+		buf.length = _buffers[index].length;
+	}
+	else
+	{
+		buf.memory = V4L2_MEMORY_MMAP;
 	}
 
-	return result;
+	if (-1 == xioctl(VIDIOC_QBUF, &buf))
+	{
+		throw_errno_exception("VIDIOC_QBUF");
+	}
+}
+
+void V4L2Grabber::releaseFrameBuffer(quint64 sequence)
+{
+	auto borrowedBuffer = _borrowedBuffers.find(sequence);
+	if (borrowedBuffer != _borrowedBuffers.end())
+	{
+		const unsigned int index = borrowedBuffer.value();
+		_borrowedBuffers.erase(borrowedBuffer);
+		queue_buffer(index);
+	}
 }
 
 void V4L2Grabber::newThreadFrame(Image<ColorRgb> image)
@@ -1213,6 +1328,17 @@ void V4L2Grabber::setCecDetectionEnable(bool enable)
 	}
 }
 
+void V4L2Grabber::setLatestFrameWins(bool enable)
+{
+	if (_latestFrameWins != enable)
+	{
+		_latestFrameWins = enable;
+		if (_threadManager != nullptr)
+			_threadManager->setLatestFrameWins(enable);
+		Debug(_log, "Latest frame wins: %s", enable ? "enabled" : "disabled");
+	}
+}
+
 bool V4L2Grabber::reload(bool force)
 {
 	if (_reload || force)
@@ -4,6 +4,8 @@
 #include <xcb/randr.h>
 #include <xcb/xcb_event.h>
 
+#include <vector>
+
 // Constants
 namespace {
 	const bool verbose = false;
@@ -107,7 +109,18 @@ void X11Grabber::setupResources()
 		_srcPicture = XRenderCreatePicture(_x11Display, _window, _srcFormat, CPRepeat, &_pictAttr);
 		_dstPicture = XRenderCreatePicture(_x11Display, _pixmap, _dstFormat, CPRepeat, &_pictAttr);
 
-		XRenderSetPictureFilter(_x11Display, _srcPicture, FilterBilinear, NULL, 0);
+		if (_pixelDecimationAveraging && _pixelDecimation > 1)
+		{
+			// box filter averaging all pixels reduced to one by the decimation
+			std::vector<XFixed> kernel(2 + _pixelDecimation * _pixelDecimation, XDoubleToFixed(1.0 / (_pixelDecimation * _pixelDecimation)));
+			kernel[0] = XDoubleToFixed(_pixelDecimation);
+			kernel[1] = XDoubleToFixed(_pixelDecimation);
+			XRenderSetPictureFilter(_x11Display, _srcPicture, FilterConvolution, kernel.data(), static_cast<int>(kernel.size()));
+		}
+		else
+		{
+			XRenderSetPictureFilter(_x11Display, _srcPicture, FilterBilinear, NULL, 0);
+		}
 	}
 	else
 	{
@@ -369,6 +382,16 @@ bool X11Grabber::setPixelDecimation(int pixelDecimation)
 	return rc;
 }
 
+void X11Grabber::setPixelDecimationAveraging(bool averaging)
+{
+	const bool changed = (averaging != _pixelDecimationAveraging);
+	Grabber::setPixelDecimationAveraging(averaging);
+	if (changed && _x11Display != nullptr)
+	{
+		updateScreenDimensions(true);
+	}
+}
+
 void X11Grabber::setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom)
 {
 	Grabber::setCropping(cropLeft, cropRight, cropTop, cropBottom);
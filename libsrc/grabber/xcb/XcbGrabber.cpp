@@ -9,6 +9,7 @@
 #include <QCoreApplication>
 
 #include <memory>
+#include <vector>
 
 // Constants
 namespace {
@@ -126,8 +127,20 @@ void XcbGrabber::setupResources()
 		query<RenderCreatePicture>(_connection, _srcPicture, _screen->root, _srcFormat, value_mask, values);
 		query<RenderCreatePicture>(_connection, _dstPicture, _pixmap, _dstFormat, value_mask, values);
 
-		const std::string filter = "fast";
-		query<RenderSetPictureFilter>(_connection, _srcPicture, filter.size(), filter.c_str(), 0, nullptr);
+		if (_pixelDecimationAveraging && _pixelDecimation > 1)
+		{
+			// box filter averaging all pixels reduced to one by the decimation
+			const std::string filter = "convolution";
+			std::vector<xcb_render_fixed_t> kernel(2 + _pixelDecimation * _pixelDecimation, DOUBLE_TO_FIXED(1.0 / (_pixelDecimation * _pixelDecimation)));
+			kernel[0] = DOUBLE_TO_FIXED(_pixelDecimation);
+			kernel[1] = DOUBLE_TO_FIXED(_pixelDecimation);
+			query<RenderSetPictureFilter>(_connection, _srcPicture, filter.size(), filter.c_str(), kernel.size(), kernel.data());
+		}
+		else
+		{
+			const std::string filter = "fast";
+			query<RenderSetPictureFilter>(_connection, _srcPicture, filter.size(), filter.c_str(), 0, nullptr);
+		}
 	}
 	else
 	{
@@ -443,6 +456,14 @@ bool XcbGrabber::setPixelDecimation(int pixelDecimation)
 	return rc;
 }
 
+void XcbGrabber::setPixelDecimationAveraging(bool averaging)
+{
+	const bool changed = (averaging != _pixelDecimationAveraging);
+	Grabber::setPixelDecimationAveraging(averaging);
+	if (changed && _connection != nullptr)
+		updateScreenDimensions(true);
+}
+
 void XcbGrabber::setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom)
 {
 	Grabber::setCropping(cropLeft, cropRight, cropTop, cropBottom);
@@ -12,25 +12,38 @@
 CaptureCont::CaptureCont(Hyperion* hyperion)
 	: QObject()
 	, _hyperion(hyperion)
+	, _imageSlots(new ImageSlotTable(hyperion::COMP_AUDIO + 1))
 	, _systemCaptEnabled(false)
 	, _systemCaptPrio(0)
 	, _systemCaptName()
 	, _systemInactiveTimer(new QTimer(this))
+	, _systemCaptHidden(false)
 	, _v4lCaptEnabled(false)
 	, _v4lCaptPrio(0)
 	, _v4lCaptName()
 	, _v4lInactiveTimer(new QTimer(this))
+	, _v4lCaptHidden(false)
 	, _audioCaptEnabled(false)
 	, _audioCaptPrio(0)
 	, _audioCaptName()
 	, _audioInactiveTimer(new QTimer(this))
+	, _audioCaptHidden(false)
 {
+	// capture images are published by the capture threads
+	_imageSlots->create(hyperion::COMP_GRABBER);
+	_imageSlots->create(hyperion::COMP_V4L);
+	_imageSlots->create(hyperion::COMP_AUDIO);
+	_imageSlots->open(this, "deliverImage");
+
 	// settings changes
 	connect(_hyperion, &Hyperion::settingsChanged, this, &CaptureCont::handleSettingsUpdate);
 
 	// comp changes
 	connect(_hyperion, &Hyperion::compStateChangeRequest, this, &CaptureCont::handleCompStateChangeRequest);
 
+	// visible priority changes
+	connect(_hyperion->getMuxerInstance(), &PriorityMuxer::visiblePriorityChanged, this, &CaptureCont::handleVisiblePriorityChange);
+
 	// inactive timer system
 	connect(_systemInactiveTimer, &QTimer::timeout, this, &CaptureCont::setSystemInactive);
 	_systemInactiveTimer->setSingleShot(true);
@@ -50,6 +63,60 @@ CaptureCont::CaptureCont(Hyperion* hyperion)
 	handleSettingsUpdate(settings::INSTCAPTURE, _hyperion->getSetting(settings::INSTCAPTURE));
 }
 
+CaptureCont::~CaptureCont()
+{
+	// capture threads may still publish, the images are dropped from now on
+	_imageSlots->close();
+}
+
+LatestValueSlotStatistics CaptureCont::getImageSlotStatistics() const
+{
+	return _imageSlots->statistics();
+}
+
+template <typename Signal_T>
+void CaptureCont::connectImageSignal(Signal_T signal, hyperion::Components component)
+{
+	// the functor holds the image slots only, the capture thread may call it while this object is destroyed
+	connect(GlobalSignals::getInstance(), signal, this, [imageSlots = _imageSlots, component](const QString& name, const Image<ColorRgb>& image) {
+		imageSlots->publish(component, qMakePair(name, image));
+	}, Qt::DirectConnection);
+}
+
+void CaptureCont::deliverImage(int component)
+{
+	QPair<QString, Image<ColorRgb>> pending;
+	if (!_imageSlots->take(component, pending))
+	{
+		return;
+	}
+
+	// an image may have been posted while the capture was disabled
+	switch (component)
+	{
+	case hyperion::COMP_GRABBER:
+		if (_systemCaptEnabled)
+		{
+			handleSystemImage(pending.first, pending.second);
+		}
+		break;
+	case hyperion::COMP_V4L:
+		if (_v4lCaptEnabled)
+		{
+			handleV4lImage(pending.first, pending.second);
+		}
+		break;
+	case hyperion::COMP_AUDIO:
+		if (_audioCaptEnabled)
+		{
+			handleAudioImage(pending.first, pending.second);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
 void CaptureCont::handleV4lImage(const QString& name, const Image<ColorRgb> & image)
 {
 	if(_v4lCaptName != name)
@@ -92,12 +159,13 @@ void CaptureCont::setSystemCaptureEnable(bool enable)
 		if(enable)
 		{
 			_hyperion->registerInput(_systemCaptPrio, hyperion::COMP_GRABBER);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, this, &CaptureCont::handleSystemImage);
+			connectImageSignal(&GlobalSignals::setSystemImage, hyperion::COMP_GRABBER);
 			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, _hyperion, &Hyperion::forwardSystemProtoMessage);
 		}
 		else
 		{
 			disconnect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, this, 0);
+			_imageSlots->discard(hyperion::COMP_GRABBER);
 			_hyperion->clear(_systemCaptPrio);
 			_systemInactiveTimer->stop();
 			_systemCaptName = "";
@@ -105,6 +173,10 @@ void CaptureCont::setSystemCaptureEnable(bool enable)
 		_systemCaptEnabled = enable;
 		_hyperion->setNewComponentState(hyperion::COMP_GRABBER, enable);
 		emit GlobalSignals::getInstance()->requestSource(hyperion::COMP_GRABBER, int(_hyperion->getInstanceIndex()), enable);
+
+		// a capture interface forgets the state of a leaving listener and assumes a new one to show its images
+		_systemCaptHidden = false;
+		updateSourceVisibility(hyperion::COMP_GRABBER, _systemCaptEnabled, _systemCaptPrio, _hyperion->getCurrentPriority(), _systemCaptHidden);
 	}
 }
 
@@ -115,12 +187,13 @@ void CaptureCont::setV4LCaptureEnable(bool enable)
 		if(enable)
 		{
 			_hyperion->registerInput(_v4lCaptPrio, hyperion::COMP_V4L);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, this, &CaptureCont::handleV4lImage);
+			connectImageSignal(&GlobalSignals::setV4lImage, hyperion::COMP_V4L);
 			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, _hyperion, &Hyperion::forwardV4lProtoMessage);
 		}
 		else
 		{
 			disconnect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, this, 0);
+			_imageSlots->discard(hyperion::COMP_V4L);
 			_hyperion->clear(_v4lCaptPrio);
 			_v4lInactiveTimer->stop();
 			_v4lCaptName = "";
@@ -128,6 +201,10 @@ void CaptureCont::setV4LCaptureEnable(bool enable)
 		_v4lCaptEnabled = enable;
 		_hyperion->setNewComponentState(hyperion::COMP_V4L, enable);
 		emit GlobalSignals::getInstance()->requestSource(hyperion::COMP_V4L, int(_hyperion->getInstanceIndex()), enable);
+
+		// a capture interface forgets the state of a leaving listener and assumes a new one to show its images
+		_v4lCaptHidden = false;
+		updateSourceVisibility(hyperion::COMP_V4L, _v4lCaptEnabled, _v4lCaptPrio, _hyperion->getCurrentPriority(), _v4lCaptHidden);
 	}
 }
 
@@ -138,12 +215,13 @@ void CaptureCont::setAudioCaptureEnable(bool enable)
 		if (enable)
 		{
 			_hyperion->registerInput(_audioCaptPrio, hyperion::COMP_AUDIO);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, this, &CaptureCont::handleAudioImage);
+			connectImageSignal(&GlobalSignals::setAudioImage, hyperion::COMP_AUDIO);
 			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, _hyperion, &Hyperion::forwardAudioProtoMessage);
 		}
 		else
 		{
 			disconnect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, this, 0);
+			_imageSlots->discard(hyperion::COMP_AUDIO);
 			_hyperion->clear(_audioCaptPrio);
 			_audioInactiveTimer->stop();
 			_audioCaptName = "";
@@ -151,6 +229,10 @@ void CaptureCont::setAudioCaptureEnable(bool enable)
 		_audioCaptEnabled = enable;
 		_hyperion->setNewComponentState(hyperion::COMP_AUDIO, enable);
 		emit GlobalSignals::getInstance()->requestSource(hyperion::COMP_AUDIO, int(_hyperion->getInstanceIndex()), enable);
+
+		// a capture interface forgets the state of a leaving listener and assumes a new one to show its images
+		_audioCaptHidden = false;
+		updateSourceVisibility(hyperion::COMP_AUDIO, _audioCaptEnabled, _audioCaptPrio, _hyperion->getCurrentPriority(), _audioCaptHidden);
 	}
 }
 
@@ -214,3 +296,20 @@ void CaptureCont::setAudioInactive()
 {
 	_hyperion->setInputInactive(_audioCaptPrio);
 }
+
+void CaptureCont::handleVisiblePriorityChange(int priority)
+{
+	updateSourceVisibility(hyperion::COMP_GRABBER, _systemCaptEnabled, _systemCaptPrio, priority, _systemCaptHidden);
+	updateSourceVisibility(hyperion::COMP_V4L, _v4lCaptEnabled, _v4lCaptPrio, priority, _v4lCaptHidden);
+	updateSourceVisibility(hyperion::COMP_AUDIO, _audioCaptEnabled, _audioCaptPrio, priority, _audioCaptHidden);
+}
+
+void CaptureCont::updateSourceVisibility(hyperion::Components component, bool enabled, int capturePriority, int visiblePriority, bool& hidden)
+{
+	const bool isHidden = enabled && visiblePriority < capturePriority;
+	if (hidden != isHidden)
+	{
+		hidden = isHidden;
+		emit GlobalSignals::getInstance()->requestSourceVisibility(component, int(_hyperion->getInstanceIndex()), !hidden);
+	}
+}
@@ -8,6 +8,7 @@ Grabber::Grabber(const QString& grabberName, int cropLeft, int cropRight, int cr
 	, _videoMode(VideoMode::VIDEO_2D)
 	, _videoStandard(VideoStandard::NO_CHANGE)
 	, _pixelDecimation(GrabberWrapper::DEFAULT_PIXELDECIMATION)
+	, _pixelDecimationAveraging(false)
 	, _flipMode(FlipMode::NO_CHANGE)
 	, _width(0)
 	, _height(0)
@@ -73,6 +74,18 @@ bool Grabber::setPixelDecimation(int pixelDecimation)
 	return false;
 }
 
+void Grabber::setPixelDecimationAveraging(bool averaging)
+{
+	if (_pixelDecimationAveraging != averaging)
+	{
+		Info(_log,"Set image size decimation mode to %s", averaging ? "area averaging" : "point sampling");
+		_pixelDecimationAveraging = averaging;
+	}
+
+	// Applied even if not used currently, as grabbers may fall back to the resampler later
+	_imageResampler.setPixelDecimationAveraging(averaging);
+}
+
 void Grabber::setFlipMode(FlipMode mode)
 {
 	Info(_log,"Set flipmode to %s", QSTRING_CSTR(flipModeToString(mode)));
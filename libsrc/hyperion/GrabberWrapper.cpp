@@ -30,6 +30,8 @@ GrabberWrapper::GrabberWrapper(const QString& grabberName, Grabber * ggrabber, i
 	  , _updateInterval_ms(1000/updateRate_Hz)
 	  , _ggrabber(ggrabber)
 	  , _image(0,0)
+	  , _sourceId(ImageMetadata::sourceIdOf(grabberName))
+	  , _frameSequence(0)
 {
 	GrabberWrapper::instance = this;
 
@@ -49,6 +51,7 @@ GrabberWrapper::GrabberWrapper(const QString& grabberName, Grabber * ggrabber, i
 
 	// listen for source requests
 	connect(GlobalSignals::getInstance(), &GlobalSignals::requestSource, this, &GrabberWrapper::handleSourceRequest);
+	connect(GlobalSignals::getInstance(), &GlobalSignals::requestSourceVisibility, this, &GrabberWrapper::handleSourceVisibility);
 }
 
 GrabberWrapper::~GrabberWrapper()
@@ -193,16 +196,57 @@ void GrabberWrapper::updateTimer(int interval)
 	if(_updateInterval_ms != interval)
 	{
 		_updateInterval_ms = interval;
+		applyTimerInterval();
+	}
+}
 
+void GrabberWrapper::applyTimerInterval()
+{
+	const int interval = _throttle.isHidden() ? qMax(_updateInterval_ms, InputThrottle::KEEP_ALIVE_INTERVAL_MS) : _updateInterval_ms;
+	if (_timer->interval() != interval)
+	{
 		const bool& timerWasActive = _timer->isActive();
 		_timer->stop();
-		_timer->setInterval(_updateInterval_ms);
+		_timer->setInterval(interval);
 
 		if(timerWasActive)
 			_timer->start();
 	}
 }
 
+hyperion::Components GrabberWrapper::getComponent() const
+{
+	if (_grabberName.startsWith("V4L"))
+		return hyperion::Components::COMP_V4L;
+	if (_grabberName.startsWith("Audio"))
+		return hyperion::Components::COMP_AUDIO;
+	return hyperion::Components::COMP_GRABBER;
+}
+
+void GrabberWrapper::updateThrottle()
+{
+	const QMap<int, QString>& clients = (getComponent() == hyperion::Components::COMP_V4L) ? GRABBER_V4L_CLIENTS
+		: (getComponent() == hyperion::Components::COMP_AUDIO) ? GRABBER_AUDIO_CLIENTS
+		: GRABBER_SYS_CLIENTS;
+
+	bool hidden = !clients.isEmpty();
+	for (int hyperionInd : clients.keys())
+	{
+		if (!_hiddenInstances.contains(hyperionInd))
+		{
+			hidden = false;
+			break;
+		}
+	}
+
+	if (hidden != _throttle.isHidden())
+	{
+		Debug(_log, "Grabber images are %s", hidden ? "hidden by a higher priority, throttle capturing" : "visible again, capture at full rate");
+		_throttle.setHidden(hidden);
+		applyTimerInterval();
+	}
+}
+
 void GrabberWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
 {
 	if (type == settings::SYSTEMCAPTURE &&
@@ -228,6 +272,7 @@ void GrabberWrapper::handleSettingsUpdate(settings::type type, const QJsonDocume
 
 			// pixel decimation for x11
 			_ggrabber->setPixelDecimation(obj["pixelDecimation"].toInt(DEFAULT_PIXELDECIMATION));
+			_ggrabber->setPixelDecimationAveraging(obj["pixelDecimationAveraging"].toBool(false));
 
 			// crop for system capture
 			_ggrabber->setCropping(
@@ -255,6 +300,10 @@ void GrabberWrapper::handleSettingsUpdate(settings::type type, const QJsonDocume
 
 void GrabberWrapper::handleSourceRequest(hyperion::Components component, int hyperionInd, bool listen)
 {
+	// a leaving listener does not hide the images anymore
+	if (component == getComponent() && !listen)
+		_hiddenInstances.remove(hyperionInd);
+
 	if (component == hyperion::Components::COMP_GRABBER &&
 		!_grabberName.startsWith("V4L") &&
 		!_grabberName.startsWith("Audio"))
@@ -295,6 +344,21 @@ void GrabberWrapper::handleSourceRequest(hyperion::Components component, int hyp
 		else
 			start();
 	}
+
+	updateThrottle();
+}
+
+void GrabberWrapper::handleSourceVisibility(hyperion::Components component, int hyperionInd, bool visible)
+{
+	if (component != getComponent())
+		return;
+
+	if (visible)
+		_hiddenInstances.remove(hyperionInd);
+	else
+		_hiddenInstances.insert(hyperionInd);
+
+	updateThrottle();
 }
 
 void GrabberWrapper::tryStart()
@@ -70,6 +70,7 @@ Hyperion::Hyperion(quint8 instance, bool readonlyMode)
 	, _BGEffectHandler(nullptr)
 	, _captureCont(nullptr)
 	, _ledBuffer(_ledString.leds().size(), ColorRgb::BLACK)
+	, _lastWrittenCaptureTime(0)
 #if defined(ENABLE_BOBLIGHT_SERVER)
 	, _boblightServer(nullptr)
 #endif
@@ -85,6 +86,8 @@ Hyperion::Hyperion(quint8 instance, bool readonlyMode)
 	_componentRegister = new ComponentRegister(this);
 	_imageProcessor = new ImageProcessor(_ledString, this);
 	_muxer = new PriorityMuxer(static_cast<int>(_ledString.leds().size()), this);
+	_inputImageSlots = _muxer->getImageSlotTable();
+	_inputImageSlots->open(this, "deliverInputImage");
 }
 
 Hyperion::~Hyperion()
@@ -119,6 +122,11 @@ void Hyperion::start()
 	connect(_muxer, &PriorityMuxer::visiblePriorityChanged, this, &Hyperion::handleSourceAvailability);
 	connect(_muxer, &PriorityMuxer::visibleComponentChanged, this, &Hyperion::handleVisibleComponentChanged);
 
+	// tell the global inputs the visible priority on every change of the priorities, which also reaches inputs activated later
+	connect(_muxer, &PriorityMuxer::prioritiesChanged, this, [this](int currentPriority) {
+		emit GlobalSignals::getInstance()->visiblePriorityChanged(int(_instIndex), currentPriority);
+	});
+
 	// listen for suspend/resume, idle requests to perform core activation/deactivation actions
 	connect(this, &Hyperion::suspendRequest, this, &Hyperion::setSuspend);
 	connect(this, &Hyperion::idleRequest, this, &Hyperion::setIdle);
@@ -175,9 +183,15 @@ void Hyperion::start()
 
 	// forwards global signals to the corresponding slots
 	connect(GlobalSignals::getInstance(), &GlobalSignals::registerGlobalInput, this, &Hyperion::registerInput);
-	connect(GlobalSignals::getInstance(), &GlobalSignals::clearGlobalInput, this, &Hyperion::clear);
+	// clears are posted by the sending thread, so its images posted afterwards are set after the clear
+	connect(GlobalSignals::getInstance(), &GlobalSignals::clearGlobalInput, this, [imageSlots = _inputImageSlots](int priority, bool forceClearAll) {
+		Hyperion::postClear(imageSlots, priority, forceClearAll);
+	}, Qt::DirectConnection);
 	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalColor, this, &Hyperion::setColor);
-	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalImage, this, &Hyperion::setInputImage);
+	// images are posted by the sending thread and coalesced per priority, if the instance cannot keep up
+	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalImage, this, [imageSlots = _inputImageSlots](int priority, const Image<ColorRgb>& image, int timeout_ms, bool clearEffect) {
+		Hyperion::postInputImage(imageSlots, priority, image, timeout_ms, clearEffect);
+	}, Qt::DirectConnection);
 
 	// if there is no startup / background effect and no sending capture interface we probably want to push once BLACK (as PrioMuxer won't emit a priority change)
 	update();
@@ -200,6 +214,9 @@ void Hyperion::stop()
 
 void Hyperion::freeObjects()
 {
+	// drop images posted from now on, the image slots survive the muxer for producers still holding them
+	_inputImageSlots->close();
+
 	//delete Background effect first that it does not kick in when other priorities are stopped
 	delete _BGEffectHandler;
 
@@ -229,6 +246,9 @@ void Hyperion::freeObjects()
 	delete _imageProcessor;
 	delete _muxer;
 	delete _componentRegister;
+
+	// a stopped instance does not hide the global inputs anymore
+	emit GlobalSignals::getInstance()->visiblePriorityChanged(int(_instIndex), -1);
 }
 
 void Hyperion::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
@@ -448,6 +468,67 @@ bool Hyperion::setInputImage(int priority, const Image<ColorRgb>& image, int64_t
 	return false;
 }
 
+void Hyperion::postInputImage(int priority, const Image<ColorRgb>& image, int64_t timeout_ms, bool clearEffect)
+{
+	postInputImage(_inputImageSlots, priority, image, timeout_ms, clearEffect);
+}
+
+void Hyperion::postInputImage(const QSharedPointer<PriorityMuxer::ImageSlotTable>& imageSlots, int priority, const Image<ColorRgb>& image, int64_t timeout_ms, bool clearEffect)
+{
+	if (imageSlots->publish(priority, PriorityMuxer::InputImage{image, timeout_ms, clearEffect}))
+	{
+		return;
+	}
+
+	// the priority is not registered yet, keep the order with a registerInput() queued before
+	imageSlots->withReceiver([&](QObject* receiver) {
+		QMetaObject::invokeMethod(receiver, "setInputImage", Qt::QueuedConnection, Q_ARG(int, priority), Q_ARG(Image<ColorRgb>, image), Q_ARG(int64_t, timeout_ms), Q_ARG(bool, clearEffect));
+	});
+}
+
+void Hyperion::deliverInputImage(int priority)
+{
+	PriorityMuxer::InputImage input;
+	if (_inputImageSlots->take(priority, input))
+	{
+		setInputImage(priority, input.image, input.timeout_ms, input.clearEffect);
+	}
+}
+
+void Hyperion::postClear(int priority, bool forceClearAll)
+{
+	postClear(_inputImageSlots, priority, forceClearAll);
+}
+
+void Hyperion::postClear(const QSharedPointer<PriorityMuxer::ImageSlotTable>& imageSlots, int priority, bool forceClearAll)
+{
+	imageSlots->requestClear([&](QObject* receiver, quint32 sequence) {
+		QMetaObject::invokeMethod(receiver, "runPostedClear", Qt::QueuedConnection, Q_ARG(int, priority), Q_ARG(bool, forceClearAll), Q_ARG(quint32, sequence));
+	});
+}
+
+void Hyperion::runPostedClear(int priority, bool forceClearAll, quint32 sequence)
+{
+	_inputImageSlots->runClear(sequence, [&]() {
+		clear(priority, forceClearAll);
+	});
+}
+
+QSharedPointer<PriorityMuxer::ImageSlotTable> Hyperion::getInputImageSlots() const
+{
+	return _inputImageSlots;
+}
+
+LatestValueSlotStatistics Hyperion::getInputSlotStatistics() const
+{
+	LatestValueSlotStatistics statistics = _inputImageSlots->statistics();
+	if (_captureCont != nullptr)
+	{
+		statistics += _captureCont->getImageSlotStatistics();
+	}
+	return statistics;
+}
+
 bool Hyperion::setInputInactive(quint8 priority)
 {
 	return _muxer->setInputInactive(priority);
@@ -659,10 +740,11 @@ void Hyperion::update()
 {
 	// Obtain the current priority channel
 	int priority = _muxer->getCurrentPriority();
-	const PriorityMuxer::InputInfo priorityInfo = _muxer->getInputInfo(priority);
+	const PriorityMuxer::InputInfo& priorityInfo = _muxer->getInputInfo(priority);
 
-	// copy image & process OR copy ledColors from muxer
-	Image<ColorRgb> image = priorityInfo.image;
+	// share image & process OR copy ledColors from muxer, the image is const and is never detached (deep copied)
+	const Image<ColorRgb> image = priorityInfo.image;
+	const ImageMetadata metadata = priorityInfo.metadata;
 	if (image.width() > 1 || image.height() > 1)
 	{
 		emit currentImage(image);
@@ -721,14 +803,17 @@ void Hyperion::update()
 		// Smoothing is disabled
 		if  (! _deviceSmooth->enabled())
 		{
-			emit ledDeviceData(_ledBuffer);
+			// an image evaluated again (priority, adjustment or time trigger) was written before, its capture time is no new sample
+			const qint64 captureTime = (metadata.captureTime != _lastWrittenCaptureTime) ? metadata.captureTime : 0;
+			_lastWrittenCaptureTime = metadata.captureTime;
+			emit ledDeviceData(_ledBuffer, captureTime);
 		}
 		else
 		{
 			// feed smoothing in pause mode to maintain a smooth transition back to smooth mode
 			if (_deviceSmooth->enabled() || _deviceSmooth->pause())
 			{
-				_deviceSmooth->updateLedValues(_ledBuffer);
+				_deviceSmooth->updateLedValues(_ledBuffer, metadata);
 			}
 		}
 	}
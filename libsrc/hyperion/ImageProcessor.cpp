@@ -9,6 +9,10 @@
 
 #include <QSharedPointer>
 #include <QRgb>
+#include <QThread>
+
+// STL includes
+#include <algorithm>
 
 using namespace hyperion;
 
@@ -18,9 +22,24 @@ void ImageProcessor::registerProcessingUnit(
 		int horizontalBorder,
 		int verticalBorder)
 {
+	// Any mapping still built in the background is outdated now
+	++_mapGeneration;
+	_mapRequestPending = false;
+
 	if (width > 0 && height > 0)
 	{
-		_imageToLedColors = QSharedPointer<ImageToLedsMap>(new ImageToLedsMap(
+		const MappingKey key = mappingKey(width, height, horizontalBorder, verticalBorder);
+		_activeKey = key;
+
+		const QSharedPointer<ImageToLedsMap>* cachedMap = _mappingCache.find(key);
+		if (cachedMap != nullptr)
+		{
+			activateProcessingUnit(*cachedMap);
+			requestFrequentProcessingUnit();
+			return;
+		}
+
+		const QSharedPointer<ImageToLedsMap> map(new ImageToLedsMap(
 								_log,
 								width,
 								height,
@@ -30,6 +49,9 @@ void ImageProcessor::registerProcessingUnit(
 								_reducedPixelSetFactorFactor,
 								_accuraryLevel
 								));
+		_mappingCache.insert(key, map);
+		activateProcessingUnit(map);
+		requestFrequentProcessingUnit();
 	}
 	else
 	{
@@ -37,6 +59,190 @@ void ImageProcessor::registerProcessingUnit(
 	}
 }
 
+ImageProcessor::MappingKey ImageProcessor::mappingKey(const ImageToLedsMap& map) const
+{
+	return mappingKey(map.width(), map.height(), map.horizontalBorder(), map.verticalBorder());
+}
+
+ImageProcessor::MappingKey ImageProcessor::mappingKey(int width, int height, int horizontalBorder, int verticalBorder) const
+{
+	return {width, height, horizontalBorder, verticalBorder, _reducedPixelSetFactorFactor};
+}
+
+bool ImageProcessor::sameGeometry(const MappingKey& key, const MappingKey& other)
+{
+	return key.width == other.width && key.height == other.height
+		&& key.horizontalBorder == other.horizontalBorder && key.verticalBorder == other.verticalBorder;
+}
+
+void ImageProcessor::switchBorder(int width, int height, int horizontalBorder, int verticalBorder)
+{
+	const MappingKey key = mappingKey(width, height, horizontalBorder, verticalBorder);
+	countBorder(key);
+
+	// A new image size has to be processed with a mapping of the same size immediately
+	if (_imageToLedColors.isNull() || _imageToLedColors->width() != width || _imageToLedColors->height() != height)
+	{
+		registerProcessingUnit(width, height, horizontalBorder, verticalBorder);
+		return;
+	}
+
+	_activeKey = key;
+
+	if (mappingKey(*_imageToLedColors) == key)
+	{
+		// Switched back, while the mapping of another border was built
+		return;
+	}
+
+	const QSharedPointer<ImageToLedsMap>* cachedMap = _mappingCache.find(key);
+	if (cachedMap != nullptr)
+	{
+		activateProcessingUnit(*cachedMap);
+	}
+	else
+	{
+		// Keep processing with the current border, until the mapping of the new one is built
+		Debug(_log, "Build LED mapping for border %d/%d in the background", horizontalBorder, verticalBorder);
+		requestProcessingUnit(key);
+	}
+}
+
+void ImageProcessor::countBorder(const MappingKey& key)
+{
+	for (auto& borderCount : _borderCounts)
+	{
+		if (sameGeometry(borderCount.first, key))
+		{
+			++borderCount.second;
+			return;
+		}
+	}
+
+	if (_borderCounts.size() >= BORDER_STATISTICS_CAPACITY)
+	{
+		_borderCounts.erase(std::min_element(_borderCounts.begin(), _borderCounts.end(),
+			[](const std::pair<MappingKey, quint32>& count, const std::pair<MappingKey, quint32>& other) { return count.second < other.second; }));
+	}
+	_borderCounts.emplace_back(key, 1);
+}
+
+ImageToLedsMapBuilder* ImageProcessor::mapBuilder()
+{
+	if (_mapBuilder == nullptr)
+	{
+		_mapBuilderThread = new QThread(this);
+		_mapBuilderThread->setObjectName("ImageToLedsMapBuilderThread");
+		_mapBuilder = new ImageToLedsMapBuilder();
+		_mapBuilder->moveToThread(_mapBuilderThread);
+		connect(_mapBuilder, &ImageToLedsMapBuilder::mapBuilt, this, &ImageProcessor::handleMapBuilt);
+		_mapBuilderThread->start();
+	}
+	return _mapBuilder;
+}
+
+void ImageProcessor::requestProcessingUnit(const MappingKey& key)
+{
+	++_mapGeneration;
+	_mapRequestPending = true;
+	mapBuilder()->requestMap(_log, key.width, key.height, key.horizontalBorder, key.verticalBorder, _ledString.leds(),
+							 key.reducedPixelSetFactor, _accuraryLevel, _mapGeneration, thread());
+}
+
+void ImageProcessor::requestFrequentProcessingUnit()
+{
+	if (_mapRequestPending || _imageToLedColors.isNull())
+	{
+		return;
+	}
+
+	// The most frequently detected borders of the current image size, as many as are cached besides the active one
+	std::vector<std::pair<MappingKey, quint32>> frequentBorders;
+	for (const auto& borderCount : _borderCounts)
+	{
+		if (borderCount.first.width == _activeKey.width && borderCount.first.height == _activeKey.height
+			&& borderCount.second >= FREQUENT_BORDER_COUNT)
+		{
+			frequentBorders.push_back(borderCount);
+		}
+	}
+	std::sort(frequentBorders.begin(), frequentBorders.end(),
+		[](const std::pair<MappingKey, quint32>& count, const std::pair<MappingKey, quint32>& other) { return count.second > other.second; });
+	if (frequentBorders.size() > MAPPING_CACHE_CAPACITY - 1)
+	{
+		frequentBorders.resize(MAPPING_CACHE_CAPACITY - 1);
+	}
+
+	for (const auto& frequentBorder : frequentBorders)
+	{
+		const MappingKey key = mappingKey(frequentBorder.first.width, frequentBorder.first.height,
+										  frequentBorder.first.horizontalBorder, frequentBorder.first.verticalBorder);
+		if (!sameGeometry(key, _activeKey) && !_mappingCache.contains(key))
+		{
+			requestProcessingUnit(key);
+			return;
+		}
+	}
+}
+
+void ImageProcessor::activateProcessingUnit(const QSharedPointer<ImageToLedsMap>& map)
+{
+	map->setAccuracyLevel(_accuraryLevel);
+	map->setDominantColorRefinement(_dominantColorRefinement);
+	map->setWorkerPool(_workerPool);
+	map->setIntegralImage(_integralImage);
+
+	if (!_imageToLedColors.isNull() && _imageToLedColors != map)
+	{
+		map->takeOverProcessingState(*_imageToLedColors);
+	}
+
+	_imageToLedColors = map;
+}
+
+void ImageProcessor::requestProcessingUnitUpdate()
+{
+	const MappingKey activeKey = mappingKey(_activeKey.width, _activeKey.height, _activeKey.horizontalBorder, _activeKey.verticalBorder);
+	if (!sameGeometry(mappingKey(*_imageToLedColors), activeKey))
+	{
+		// The mapping of a new border is built, build it for the updated settings instead
+		requestProcessingUnit(activeKey);
+		return;
+	}
+
+	++_mapGeneration;
+	_mapRequestPending = true;
+	mapBuilder()->requestMap(_imageToLedColors, _ledString.leds(), _reducedPixelSetFactorFactor, _accuraryLevel, _mapGeneration, thread());
+}
+
+void ImageProcessor::handleMapBuilt()
+{
+	quint64 generation = 0;
+	const QSharedPointer<ImageToLedsMap> map = _mapBuilder->takeMap(generation);
+
+	// Drop mappings superseded by a later request or by a mapping for another image size or border
+	if (map.isNull() || generation != _mapGeneration)
+	{
+		return;
+	}
+
+	_mapRequestPending = false;
+	if (_imageToLedColors.isNull())
+	{
+		return;
+	}
+
+	// Mappings of frequent borders built in advance are only cached
+	_mappingCache.insert(mappingKey(*map), map);
+	if (sameGeometry(mappingKey(*map), _activeKey))
+	{
+		activateProcessingUnit(map);
+		Debug(_log, "Updated LED mapping activated");
+	}
+
+	requestFrequentProcessingUnit();
+}
+
 // global transform method
 int ImageProcessor::mappingTypeToInt(const QString& mappingType)
 {
@@ -56,6 +262,10 @@ int ImageProcessor::mappingTypeToInt(const QString& mappingType)
 	{
 		return 4;
 	}
+	else if (mappingType == "multicolor_mean_integral" )
+	{
+		return 5;
+	}
 	return 0;
 }
 // global transform method
@@ -75,6 +285,9 @@ QString ImageProcessor::mappingTypeToStr(int mappingType)
 	case 4:
 		typeText = "dominant_color_advanced";
 		break;
+	case 5:
+		typeText = "multicolor_mean_integral";
+		break;
 	default:
 		typeText = "multicolor_mean";
 		break;
@@ -94,6 +307,16 @@ ImageProcessor::ImageProcessor(const LedString& ledString, Hyperion* hyperion)
 	, _hardMappingType(-1)
 	, _accuraryLevel(0)
 	, _reducedPixelSetFactorFactor(1)
+	, _dominantColorRefinement(true)
+	, _workerPool(nullptr)
+	, _integralImage(new ImageToLedsMap::IntegralImage())
+	, _mapBuilder(nullptr)
+	, _mapBuilderThread(nullptr)
+	, _mapGeneration(0)
+	, _mapRequestPending(false)
+	, _activeKey{0, 0, 0, 0, 0}
+	, _mappingCache(MAPPING_CACHE_CAPACITY)
+	, _borderCounts()
 	, _hyperion(hyperion)
 {
 	QString subComponent = hyperion->property("instance").toString();
@@ -107,6 +330,12 @@ ImageProcessor::ImageProcessor(const LedString& ledString, Hyperion* hyperion)
 
 ImageProcessor::~ImageProcessor()
 {
+	if (_mapBuilderThread != nullptr)
+	{
+		_mapBuilderThread->quit();
+		_mapBuilderThread->wait();
+		delete _mapBuilder;
+	}
 }
 
 void ImageProcessor::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
@@ -125,6 +354,10 @@ void ImageProcessor::handleSettingsUpdate(settings::type type, const QJsonDocume
 
 		int accuracyLevel = obj["accuracyLevel"].toInt();
 		setAccuracyLevel(accuracyLevel);
+
+		setDominantColorRefinement(obj["dominantColorRefinement"].toBool(true));
+
+		setWorkerThreads(obj["workerThreads"].toInt(1));
 	}
 }
 
@@ -145,14 +378,22 @@ void ImageProcessor::setLedString(const LedString& ledString)
 	Debug(_log,"");
 	if ( !_imageToLedColors.isNull() )
 	{
+		const bool sameLedCount = (ledString.leds().size() == _ledString.leds().size());
 		_ledString = ledString;
 
-		// get current width/height
-		int width = _imageToLedColors->width();
-		int height = _imageToLedColors->height();
+		// Cached mappings are based on the previous LED string
+		_mappingCache.clear();
 
-		// Construct a new buffer and mapping
-		registerProcessingUnit(width, height, 0, 0);
+		if (sameLedCount)
+		{
+			// Keep processing with the current mapping, until the updated one is built
+			requestProcessingUnitUpdate();
+		}
+		else
+		{
+			// The number of LED colors has to match the LED string immediately
+			registerProcessingUnit(_activeKey.width, _activeKey.height, _activeKey.horizontalBorder, _activeKey.verticalBorder);
+		}
 	}
 }
 
@@ -175,11 +416,20 @@ void ImageProcessor::setReducedPixelSetFactorFactor(int count)
 
 	if (currentReducedPixelSetFactor != _reducedPixelSetFactorFactor && !_imageToLedColors.isNull())
 	{
-		int width = _imageToLedColors->width();
-		int height = _imageToLedColors->height();
-
-		// Construct a new buffer and mapping
-		registerProcessingUnit(width, height, 0, 0);
+		const QSharedPointer<ImageToLedsMap>* cachedMap = _mappingCache.find(
+			mappingKey(_activeKey.width, _activeKey.height, _activeKey.horizontalBorder, _activeKey.verticalBorder));
+		if (cachedMap != nullptr)
+		{
+			++_mapGeneration;
+			_mapRequestPending = false;
+			activateProcessingUnit(*cachedMap);
+			requestFrequentProcessingUnit();
+		}
+		else
+		{
+			// Keep processing with the current mapping, until the updated one is built
+			requestProcessingUnitUpdate();
+		}
 	}
 }
 
@@ -194,27 +444,56 @@ void ImageProcessor::setAccuracyLevel(int level)
 	}
 }
 
-void ImageProcessor::setLedMappingType(int mapType)
+void ImageProcessor::setDominantColorRefinement(bool enable)
+{
+	_dominantColorRefinement = enable;
+	Debug(_log, "Set dominant color refinement to %s", _dominantColorRefinement ? "enabled" : "disabled");
+
+	if (!_imageToLedColors.isNull())
+	{
+		_imageToLedColors->setDominantColorRefinement(_dominantColorRefinement);
+	}
+}
+
+void ImageProcessor::setWorkerThreads(int threads)
 {
-	int currentMappingType = _mappingType;
+	const int currentThreads = _workerPool.isNull() ? 1 : _workerPool->threadCount();
+	threads = qMax(threads, 1);
+
+	if (threads == currentThreads)
+	{
+		return;
+	}
 
+	Debug(_log, "Set LED processing threads to %d", threads);
+
+	if (threads > 1)
+	{
+		_workerPool = QSharedPointer<WorkerPool>(new WorkerPool(threads, "ImageToLedsWorker"));
+	}
+	else
+	{
+		_workerPool.clear();
+	}
+
+	if (!_imageToLedColors.isNull())
+	{
+		_imageToLedColors->setWorkerPool(_workerPool);
+	}
+}
+
+void ImageProcessor::setLedMappingType(int mapType)
+{
 	// if the _hardMappingType is >-1 we aren't allowed to overwrite it
 	_userMappingType = mapType;
 
 	Debug(_log, "Set user LED mapping to %s", QSTRING_CSTR(mappingTypeToStr(mapType)));
 
+	// The mapping does not depend on the mapping type, it is used as is
 	if(_hardMappingType == -1)
 	{
 		_mappingType = mapType;
 	}
-
-	if (currentMappingType != _mappingType && !_imageToLedColors.isNull())
-	{
-		int width = _imageToLedColors->width();
-		int height = _imageToLedColors->height();
-
-		registerProcessingUnit(width, height, 0, 0);
-	}
 }
 
 void ImageProcessor::setHardLedMappingType(int mapType)
@@ -1,7 +1,384 @@
 #include <hyperion/ImageToLedsMap.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define IMAGETOLEDSMAP_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define IMAGETOLEDSMAP_NEON
+#endif
+
 using namespace hyperion;
 
+namespace {
+
+/// Number of RGB pixels (48 bytes) processed per SIMD iteration
+constexpr int SIMD_BLOCK_PIXELS = 16;
+
+///
+/// Sums up the channels of the given pixels
+///
+struct PixelSum
+{
+	void operator()(const ColorRgb* pixel, const ColorRgb* end, uint64_t sum[3]) const
+	{
+		// Stay within 32 bits in the inner loop, a single row of an area cannot overflow them
+		uint32_t red = 0, green = 0, blue = 0;
+		for (; pixel != end; ++pixel)
+		{
+			red   += pixel->red;
+			green += pixel->green;
+			blue  += pixel->blue;
+		}
+		sum[0] += red;
+		sum[1] += green;
+		sum[2] += blue;
+	}
+};
+
+///
+/// Sums up the squared channels of the given pixels
+///
+struct PixelSquaredSum
+{
+	void operator()(const ColorRgb* pixel, const ColorRgb* end, uint64_t sum[3]) const
+	{
+		// Stay within 32 bits in the inner loop, a single row of an area cannot overflow them
+		uint32_t red = 0, green = 0, blue = 0;
+		for (; pixel != end; ++pixel)
+		{
+			red   += pixel->red * pixel->red;
+			green += pixel->green * pixel->green;
+			blue  += pixel->blue * pixel->blue;
+		}
+		sum[0] += red;
+		sum[1] += green;
+		sum[2] += blue;
+	}
+};
+
+#if defined(IMAGETOLEDSMAP_SSE2)
+
+///
+/// Sums up the channels of contiguous RGB rows. A block of 16 pixels is loaded as three 16 byte
+/// vectors, byte i of a block belongs to color channel i % 3. The bytes are accumulated per
+/// block position in 16 bit lanes, which are folded into 32 bit totals before they can overflow.
+///
+class RowAccumulator
+{
+public:
+	RowAccumulator() : _lanes(), _acc(), _pending(0)
+	{
+		clearAcc();
+	}
+
+	void addBlock(const uint8_t* data)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (int k = 0; k < 3; ++k)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * k));
+			_acc[2*k]   = _mm_add_epi16(_acc[2*k],   _mm_unpacklo_epi8(v, zero));
+			_acc[2*k+1] = _mm_add_epi16(_acc[2*k+1], _mm_unpackhi_epi8(v, zero));
+		}
+
+		// 16 bit lanes hold at least 257 * 255
+		if (++_pending == 256)
+		{
+			flush();
+		}
+	}
+
+	void finish(uint64_t sum[3])
+	{
+		flush();
+		for (int i = 0; i < 48; ++i)
+		{
+			sum[i % 3] += _lanes[i];
+		}
+	}
+
+private:
+	void clearAcc()
+	{
+		for (__m128i& acc : _acc)
+		{
+			acc = _mm_setzero_si128();
+		}
+	}
+
+	void flush()
+	{
+		if (_pending == 0)
+		{
+			return;
+		}
+
+		alignas(16) uint16_t partial[48];
+		for (int i = 0; i < 6; ++i)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(partial + 8 * i), _acc[i]);
+		}
+		for (int i = 0; i < 48; ++i)
+		{
+			_lanes[i] += partial[i];
+		}
+		clearAcc();
+		_pending = 0;
+	}
+
+	uint64_t _lanes[48];
+	__m128i _acc[6];
+	int _pending;
+};
+
+///
+/// Sums up the squared channels of contiguous RGB rows. Works like RowAccumulator, the squares
+/// are calculated in 16 bit lanes and accumulated in 32 bit lanes.
+///
+class RowSquaredAccumulator
+{
+public:
+	RowSquaredAccumulator() : _lanes(), _acc(), _pending(0)
+	{
+		clearAcc();
+	}
+
+	void addBlock(const uint8_t* data)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (int k = 0; k < 3; ++k)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * k));
+			const __m128i lo = _mm_unpacklo_epi8(v, zero);
+			const __m128i hi = _mm_unpackhi_epi8(v, zero);
+			const __m128i loSquared = _mm_mullo_epi16(lo, lo);
+			const __m128i hiSquared = _mm_mullo_epi16(hi, hi);
+			_acc[4*k]   = _mm_add_epi32(_acc[4*k],   _mm_unpacklo_epi16(loSquared, zero));
+			_acc[4*k+1] = _mm_add_epi32(_acc[4*k+1], _mm_unpackhi_epi16(loSquared, zero));
+			_acc[4*k+2] = _mm_add_epi32(_acc[4*k+2], _mm_unpacklo_epi16(hiSquared, zero));
+			_acc[4*k+3] = _mm_add_epi32(_acc[4*k+3], _mm_unpackhi_epi16(hiSquared, zero));
+		}
+
+		// 32 bit lanes hold at least 66051 * 255^2
+		if (++_pending == 65536)
+		{
+			flush();
+		}
+	}
+
+	void finish(uint64_t sum[3])
+	{
+		flush();
+		for (int i = 0; i < 48; ++i)
+		{
+			sum[i % 3] += _lanes[i];
+		}
+	}
+
+private:
+	void clearAcc()
+	{
+		for (__m128i& acc : _acc)
+		{
+			acc = _mm_setzero_si128();
+		}
+	}
+
+	void flush()
+	{
+		if (_pending == 0)
+		{
+			return;
+		}
+
+		alignas(16) uint32_t partial[48];
+		for (int i = 0; i < 12; ++i)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(partial + 4 * i), _acc[i]);
+		}
+		for (int i = 0; i < 48; ++i)
+		{
+			_lanes[i] += partial[i];
+		}
+		clearAcc();
+		_pending = 0;
+	}
+
+	uint64_t _lanes[48];
+	__m128i _acc[12];
+	int _pending;
+};
+
+#elif defined(IMAGETOLEDSMAP_NEON)
+
+///
+/// Sums up the channels of contiguous RGB rows. A block of 16 pixels is deinterleaved into one
+/// vector per color channel and pairwise accumulated in 16 bit lanes, which are folded into
+/// 32 bit totals before they can overflow.
+///
+class RowAccumulator
+{
+public:
+	RowAccumulator() : _pending(0)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			_acc[c] = vdupq_n_u16(0);
+			_total[c] = vdupq_n_u32(0);
+		}
+	}
+
+	void addBlock(const uint8_t* data)
+	{
+		const uint8x16x3_t v = vld3q_u8(data);
+		for (int c = 0; c < 3; ++c)
+		{
+			_acc[c] = vpadalq_u8(_acc[c], v.val[c]);
+		}
+
+		// 16 bit lanes hold at least 128 * 2 * 255
+		if (++_pending == 128)
+		{
+			flush();
+		}
+	}
+
+	void finish(uint64_t sum[3])
+	{
+		flush();
+		for (int c = 0; c < 3; ++c)
+		{
+			uint32_t lanes[4];
+			vst1q_u32(lanes, _total[c]);
+			sum[c] += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+		}
+	}
+
+private:
+	void flush()
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			_total[c] = vpadalq_u16(_total[c], _acc[c]);
+			_acc[c] = vdupq_n_u16(0);
+		}
+		_pending = 0;
+	}
+
+	uint16x8_t _acc[3];
+	uint32x4_t _total[3];
+	int _pending;
+};
+
+///
+/// Sums up the squared channels of contiguous RGB rows. A block of 16 pixels is deinterleaved into
+/// one vector per color channel, squared into 16 bit lanes and pairwise accumulated in 32 bit lanes,
+/// which are folded into 64 bit totals before they can overflow.
+///
+class RowSquaredAccumulator
+{
+public:
+	RowSquaredAccumulator() : _pending(0)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			_acc[c] = vdupq_n_u32(0);
+			_total[c] = vdupq_n_u64(0);
+		}
+	}
+
+	void addBlock(const uint8_t* data)
+	{
+		const uint8x16x3_t v = vld3q_u8(data);
+		for (int c = 0; c < 3; ++c)
+		{
+			const uint8x8_t lo = vget_low_u8(v.val[c]);
+			const uint8x8_t hi = vget_high_u8(v.val[c]);
+			_acc[c] = vpadalq_u16(_acc[c], vmull_u8(lo, lo));
+			_acc[c] = vpadalq_u16(_acc[c], vmull_u8(hi, hi));
+		}
+
+		// 32 bit lanes hold at least 4096 * 4 * 255^2
+		if (++_pending == 4096)
+		{
+			flush();
+		}
+	}
+
+	void finish(uint64_t sum[3])
+	{
+		flush();
+		for (int c = 0; c < 3; ++c)
+		{
+			uint64_t lanes[2];
+			vst1q_u64(lanes, _total[c]);
+			sum[c] += lanes[0] + lanes[1];
+		}
+	}
+
+private:
+	void flush()
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			_total[c] = vpadalq_u32(_total[c], _acc[c]);
+			_acc[c] = vdupq_n_u32(0);
+		}
+		_pending = 0;
+	}
+
+	uint32x4_t _acc[3];
+	uint64x2_t _total[3];
+	int _pending;
+};
+
+#else
+
+/// Without SIMD support all pixels are summed up by the scalar functions
+struct RowAccumulator {};
+struct RowSquaredAccumulator {};
+
+#endif
+
+///
+/// Sums up all rows of a contiguous (step 1) area. Whole blocks of 16 pixels are summed up by the
+/// SIMD accumulator (where available), the remaining pixels of each row by the scalar function.
+///
+template <typename Accumulator_T, typename Scalar_T>
+void accumulateRows(const ColorRgb* areaData, int imageWidth, int width, int height, uint64_t sum[3])
+{
+	const Scalar_T scalarSum;
+
+#if defined(IMAGETOLEDSMAP_SSE2) || defined(IMAGETOLEDSMAP_NEON)
+	const int blocks = width / SIMD_BLOCK_PIXELS;
+	if (blocks > 0)
+	{
+		Accumulator_T accumulator;
+		for (int y = 0; y < height; ++y)
+		{
+			const ColorRgb* row = areaData + y * imageWidth;
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(row);
+			for (int block = 0; block < blocks; ++block)
+			{
+				accumulator.addBlock(data + block * SIMD_BLOCK_PIXELS * 3);
+			}
+			scalarSum(row + blocks * SIMD_BLOCK_PIXELS, row + width, sum);
+		}
+		accumulator.finish(sum);
+		return;
+	}
+#endif
+
+	for (int y = 0; y < height; ++y)
+	{
+		const ColorRgb* row = areaData + y * imageWidth;
+		scalarSum(row, row + width, sum);
+	}
+}
+
+} // end anonymous namespace
+
 ImageToLedsMap::ImageToLedsMap(
 		Logger* log,
 		int width,
@@ -16,11 +393,54 @@ ImageToLedsMap::ImageToLedsMap(
 	, _height(height)
 	, _horizontalBorder(horizontalBorder)
 	, _verticalBorder(verticalBorder)
+	, _reducedPixelSetFactor(reducedPixelSetFactor)
 	, _nextPixelCount(reducedPixelSetFactor)
 	, _clusterCount()
-	, _colorsMap()
+	, _leds()
+	, _ledAreas()
+	, _workerPool()
+	, _chunkSize(0)
+	, _chunkCount(1)
+	, _integralImage()
+	, _histograms(1)
+	, _dominantColorRefinement(true)
+	, _clusterColors()
+	, _kMeansStatistics()
 {
-	_nextPixelCount = reducedPixelSetFactor + 1;
+	buildLedAreas(leds, nullptr, accuracyLevel);
+}
+
+ImageToLedsMap::ImageToLedsMap(
+		const ImageToLedsMap& base,
+		const std::vector<Led>& leds,
+		int reducedPixelSetFactor,
+		int accuracyLevel)
+	: _log(base._log)
+	, _width(base._width)
+	, _height(base._height)
+	, _horizontalBorder(base._horizontalBorder)
+	, _verticalBorder(base._verticalBorder)
+	, _reducedPixelSetFactor(reducedPixelSetFactor)
+	, _nextPixelCount(reducedPixelSetFactor)
+	, _clusterCount()
+	, _leds()
+	, _ledAreas()
+	, _workerPool()
+	, _chunkSize(0)
+	, _chunkCount(1)
+	, _integralImage()
+	, _histograms(1)
+	, _dominantColorRefinement(true)
+	, _clusterColors()
+	, _kMeansStatistics()
+{
+	// Areas depend on the reduced pixel set factor, they can only be taken over if it is unchanged
+	buildLedAreas(leds, (reducedPixelSetFactor == base._reducedPixelSetFactor) ? &base : nullptr, accuracyLevel);
+}
+
+void ImageToLedsMap::buildLedAreas(const std::vector<Led>& leds, const ImageToLedsMap* base, int accuracyLevel)
+{
+	_nextPixelCount = _reducedPixelSetFactor + 1;
 	setAccuracyLevel(accuracyLevel);
 
 	// Sanity check of the size of the borders (and width and height)
@@ -30,7 +450,8 @@ ImageToLedsMap::ImageToLedsMap(
 	Q_ASSERT(_height < 10000);
 
 	// Reserve enough space in the map for the leds
-	_colorsMap.reserve(leds.size());
+	_leds = leds;
+	_ledAreas.reserve(leds.size());
 
 	const int xOffset      = _verticalBorder;
 	const int actualWidth  = _width  - 2 * _verticalBorder;
@@ -38,15 +459,29 @@ ImageToLedsMap::ImageToLedsMap(
 	const int actualHeight = _height - 2 * _horizontalBorder;
 
 	size_t	totalCount = 0;
-	size_t	totalCapacity = 0;
 	int     ledCounter = 0;
+	size_t  reusedCount = 0;
 
-	for (const Led& led : leds)
+	for (size_t ledIdx = 0; ledIdx < leds.size(); ++ledIdx)
 	{
+		const Led& led = leds[ledIdx];
+
 		// skip leds without area
 		if ((led.maxX_frac-led.minX_frac) < 1e-6 || (led.maxY_frac-led.minY_frac) < 1e-6)
 		{
-			_colorsMap.emplace_back();
+			_ledAreas.push_back({xOffset, yOffset, 0, 0, 1, 0});
+			continue;
+		}
+
+		// Take over the area of an unchanged LED, if it was evaluated with the same pixel step
+		if (base != nullptr && ledIdx < base->_leds.size() && hasSameGeometry(led, base->_leds[ledIdx])
+			&& base->_ledAreas[ledIdx].step == _nextPixelCount)
+		{
+			const LedArea& area = base->_ledAreas[ledIdx];
+			_ledAreas.push_back(area);
+			totalCount += static_cast<size_t>(area.pixelCount);
+			++reusedCount;
+			ledCounter++;
 			continue;
 		}
 
@@ -68,12 +503,12 @@ ImageToLedsMap::ImageToLedsMap(
 			maxY_idx++;
 		}
 
-		// Add all the indices in the above defined rectangle to the indices for this led
+		// Clip the above defined rectangle to the indexed image
 		const int maxYLedCount = qMin(maxY_idx, yOffset+actualHeight);
 		const int maxXLedCount = qMin(maxX_idx, xOffset+actualWidth);
 
-		const int realYLedCount = qAbs(maxYLedCount - minY_idx);
-		const int realXLedCount = qAbs(maxXLedCount - minX_idx);
+		const int realYLedCount = qMax(maxYLedCount - minY_idx, 0);
+		const int realXLedCount = qMax(maxXLedCount - minX_idx, 0);
 
 		bool skipPixelProcessing {false};
 		if (_nextPixelCount > 1)
@@ -90,28 +525,54 @@ ImageToLedsMap::ImageToLedsMap(
 			Warning(_log, "Mapping LED/light [%d]. The current mapping area contains %d pixels which is huge. Therefore every %d pixels will be skipped. You can enable reduced processing to hide that warning.", ledCounter, totalSize, _nextPixelCount);
 		}
 
-		std::vector<int> ledColors;
-		ledColors.reserve(totalSize);
-
-		for (int y = minY_idx; y < maxYLedCount; y += _nextPixelCount)
-		{
-			for (int x = minX_idx; x < maxXLedCount; x += _nextPixelCount)
-			{
-				ledColors.push_back( y * width + x);
-			}
-		}
+		// Number of pixels evaluated per row and per column, when evaluating every "_nextPixelCount" pixel
+		const int columns = (realXLedCount + _nextPixelCount - 1) / _nextPixelCount;
+		const int rows = (realYLedCount + _nextPixelCount - 1) / _nextPixelCount;
 
-		// Add the constructed vector to the map
-		_colorsMap.push_back(ledColors);
+		// Add the area of the above defined rectangle to the map
+		_ledAreas.push_back({minX_idx, minY_idx, realXLedCount, realYLedCount, _nextPixelCount, rows * columns});
 
-		totalCount += ledColors.size();
-		totalCapacity += ledColors.capacity();
+		totalCount += static_cast<size_t>(rows * columns);
 
 		ledCounter++;
 	}
-	Debug(_log, "Total index number is: %d (memory: %d). Reduced pixel set factor: %d, Accuracy level: %d, Image size: %d x %d, LED areas: %d",
-		totalCount, totalCapacity, reducedPixelSetFactor, accuracyLevel, width, height, leds.size());
 
+	// Seed the k-means clustering of every LED with the default cluster colors
+	resetClusterColors();
+
+	// Process all LEDs as a single chunk, until a worker pool is set
+	_chunkSize = qMax(_ledAreas.size(), size_t(1));
+
+	Debug(_log, "Total pixels evaluated: %d (memory: %d). Reduced pixel set factor: %d, Accuracy level: %d, Image size: %d x %d, LED areas: %d (%d taken over)",
+		totalCount, _ledAreas.capacity() * sizeof(LedArea), _reducedPixelSetFactor, accuracyLevel, _width, _height, leds.size(), reusedCount);
+}
+
+bool ImageToLedsMap::hasSameGeometry(const Led& led, const Led& other)
+{
+	return led.minX_frac == other.minX_frac && led.maxX_frac == other.maxX_frac
+		&& led.minY_frac == other.minY_frac && led.maxY_frac == other.maxY_frac;
+}
+
+void ImageToLedsMap::takeOverProcessingState(const ImageToLedsMap& previous)
+{
+	if (previous._clusterCount != _clusterCount)
+	{
+		return;
+	}
+
+	// Keep the k-means seeds of all LEDs evaluating the very same pixels
+	const size_t ledCount = qMin(_ledAreas.size(), previous._ledAreas.size());
+	for (size_t ledIdx = 0; ledIdx < ledCount; ++ledIdx)
+	{
+		const LedArea& area = _ledAreas[ledIdx];
+		const LedArea& previousArea = previous._ledAreas[ledIdx];
+		if (area.x == previousArea.x && area.y == previousArea.y && area.width == previousArea.width
+			&& area.height == previousArea.height && area.step == previousArea.step)
+		{
+			std::copy_n(previous._clusterColors.begin() + static_cast<std::ptrdiff_t>(ledIdx * MAX_CLUSTER_COUNT), MAX_CLUSTER_COUNT,
+				_clusterColors.begin() + static_cast<std::ptrdiff_t>(ledIdx * MAX_CLUSTER_COUNT));
+		}
+	}
 }
 
 int ImageToLedsMap::width() const
@@ -132,7 +593,85 @@ void ImageToLedsMap::setAccuracyLevel (int accuracyLevel)
 		accuracyLevel = 4;
 	}
 	//Set cluster number for dominant color advanced
-	_clusterCount  = accuracyLevel + 1;
+	if (_clusterCount != accuracyLevel + 1)
+	{
+		_clusterCount  = accuracyLevel + 1;
+		resetClusterColors();
+	}
+}
+
+void ImageToLedsMap::setWorkerPool(const QSharedPointer<WorkerPool>& workerPool)
+{
+	_workerPool = workerPool;
+
+	const size_t ledCount = _ledAreas.size();
+	const size_t threadCount = _workerPool.isNull() ? 1 : static_cast<size_t>(_workerPool->threadCount());
 
+	// Split into chunks of a multiple of the chunk granularity, not smaller than a single granularity unit per thread
+	size_t chunkSize = qMax(ledCount, size_t(1));
+	if (threadCount > 1 && ledCount >= 2 * LED_CHUNK_ALIGNMENT)
+	{
+		const size_t chunks = threadCount * LED_CHUNKS_PER_THREAD;
+		chunkSize = (ledCount + chunks - 1) / chunks;
+		chunkSize = (chunkSize + LED_CHUNK_ALIGNMENT - 1) / LED_CHUNK_ALIGNMENT * LED_CHUNK_ALIGNMENT;
+	}
+
+	_chunkSize = chunkSize;
+	_chunkCount = static_cast<int>((ledCount + _chunkSize - 1) / _chunkSize);
+	_chunkCount = qMax(_chunkCount, 1);
+	_histograms.resize(static_cast<size_t>(_chunkCount));
+
+	if (threadCount > 1)
+	{
+		Debug(_log, "Processing %d LEDs in %d chunk(s) of %d LEDs using %d threads",
+			static_cast<int>(ledCount), _chunkCount, static_cast<int>(_chunkSize), static_cast<int>(threadCount));
+	}
+}
+
+void ImageToLedsMap::resetClusterColors()
+{
+	_clusterColors.resize(_ledAreas.size() * MAX_CLUSTER_COUNT);
+	for (size_t idx = 0; idx < _clusterColors.size(); ++idx)
+	{
+		_clusterColors[idx] = DEFAULT_CLUSTER_COLORS[idx % MAX_CLUSTER_COUNT];
+	}
 }
 
+
+void ImageToLedsMap::accumulateArea(const Image<ColorRgb> & image, const LedArea & area, uint64_t sum[3])
+{
+	if (area.step != 1)
+	{
+		forEachPixel(image, area, [&](const ColorRgb& pixel)
+		{
+			sum[0] += pixel.red;
+			sum[1] += pixel.green;
+			sum[2] += pixel.blue;
+		});
+		return;
+	}
+
+	const int imageWidth = static_cast<int>(image.width());
+	const ColorRgb* areaData = image.memptr() + area.y * imageWidth + area.x;
+
+	accumulateRows<RowAccumulator, PixelSum>(areaData, imageWidth, area.width, area.height, sum);
+}
+
+void ImageToLedsMap::accumulateAreaSquared(const Image<ColorRgb> & image, const LedArea & area, uint64_t sum[3])
+{
+	if (area.step != 1)
+	{
+		forEachPixel(image, area, [&](const ColorRgb& pixel)
+		{
+			sum[0] += pixel.red * pixel.red;
+			sum[1] += pixel.green * pixel.green;
+			sum[2] += pixel.blue * pixel.blue;
+		});
+		return;
+	}
+
+	const int imageWidth = static_cast<int>(image.width());
+	const ColorRgb* areaData = image.memptr() + area.y * imageWidth + area.x;
+
+	accumulateRows<RowSquaredAccumulator, PixelSquaredSum>(areaData, imageWidth, area.width, area.height, sum);
+}
@@ -0,0 +1,115 @@
+#include <hyperion/ImageToLedsMapBuilder.h>
+
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QThread>
+
+using namespace hyperion;
+
+ImageToLedsMapBuilder::ImageToLedsMapBuilder()
+	: QObject()
+	, _requestPending(false)
+	, _base(nullptr)
+	, _log(nullptr)
+	, _width(0)
+	, _height(0)
+	, _horizontalBorder(0)
+	, _verticalBorder(0)
+	, _leds()
+	, _reducedPixelSetFactor(0)
+	, _accuracyLevel(0)
+	, _requestGeneration(0)
+	, _targetThread(nullptr)
+	, _map(nullptr)
+	, _mapGeneration(0)
+{
+}
+
+void ImageToLedsMapBuilder::requestMap(const QSharedPointer<ImageToLedsMap>& base, const std::vector<Led>& leds,
+									   int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread)
+{
+	QMutexLocker lock(&_mutex);
+
+	_base = base;
+	scheduleBuild(leds, reducedPixelSetFactor, accuracyLevel, generation, targetThread);
+}
+
+void ImageToLedsMapBuilder::requestMap(Logger* log, int width, int height, int horizontalBorder, int verticalBorder, const std::vector<Led>& leds,
+									   int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread)
+{
+	QMutexLocker lock(&_mutex);
+
+	_base.clear();
+	_log = log;
+	_width = width;
+	_height = height;
+	_horizontalBorder = horizontalBorder;
+	_verticalBorder = verticalBorder;
+	scheduleBuild(leds, reducedPixelSetFactor, accuracyLevel, generation, targetThread);
+}
+
+void ImageToLedsMapBuilder::scheduleBuild(const std::vector<Led>& leds, int reducedPixelSetFactor, int accuracyLevel, quint64 generation, QThread* targetThread)
+{
+	const bool buildScheduled = _requestPending;
+
+	_requestPending = true;
+	_leds = leds;
+	_reducedPixelSetFactor = reducedPixelSetFactor;
+	_accuracyLevel = accuracyLevel;
+	_requestGeneration = generation;
+	_targetThread = targetThread;
+
+	// A build scheduled already will pick up the latest request
+	if (!buildScheduled)
+	{
+		QMetaObject::invokeMethod(this, "build", Qt::QueuedConnection);
+	}
+}
+
+QSharedPointer<ImageToLedsMap> ImageToLedsMapBuilder::takeMap(quint64& generation)
+{
+	QMutexLocker lock(&_mutex);
+
+	QSharedPointer<ImageToLedsMap> map = _map;
+	generation = _mapGeneration;
+	_map.clear();
+
+	return map;
+}
+
+void ImageToLedsMapBuilder::build()
+{
+	QMutexLocker lock(&_mutex);
+	if (!_requestPending)
+	{
+		return;
+	}
+
+	_requestPending = false;
+	const QSharedPointer<ImageToLedsMap> base = _base;
+	Logger* log = _log;
+	const int width = _width;
+	const int height = _height;
+	const int horizontalBorder = _horizontalBorder;
+	const int verticalBorder = _verticalBorder;
+	const std::vector<Led> leds = std::move(_leds);
+	const int reducedPixelSetFactor = _reducedPixelSetFactor;
+	const int accuracyLevel = _accuracyLevel;
+	const quint64 generation = _requestGeneration;
+	QThread* targetThread = _targetThread;
+	_base.clear();
+	_leds.clear();
+	lock.unlock();
+
+	QSharedPointer<ImageToLedsMap> map(base.isNull()
+		? new ImageToLedsMap(log, width, height, horizontalBorder, verticalBorder, leds, reducedPixelSetFactor, accuracyLevel)
+		: new ImageToLedsMap(*base, leds, reducedPixelSetFactor, accuracyLevel));
+	map->moveToThread(targetThread);
+
+	lock.relock();
+	_map = map;
+	_mapGeneration = generation;
+	lock.unlock();
+
+	emit mapBuilt();
+}
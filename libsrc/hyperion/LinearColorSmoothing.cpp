@@ -66,6 +66,7 @@ LinearColorSmoothing::LinearColorSmoothing(const QJsonDocument &config, Hyperion
 	  , _updateInterval(DEFAULT_UPDATEINTERVALL.count())
 	  , _settlingTime(DEFAULT_SETTLINGTIME)
 	  , _timer(nullptr)
+	  , _targetMetadata()
 	  , _outputDelay(DEFAULT_OUTPUTDEPLAY)
 	  , _pause(false)
 	  , _currentConfigId(SmoothingConfigID::SYSTEM)
@@ -94,7 +95,7 @@ LinearColorSmoothing::LinearColorSmoothing(const QJsonDocument &config, Hyperion
 	connect(_timer, &QTimer::timeout, this, &LinearColorSmoothing::updateLeds);
 
 	connect(_prioMuxer, &PriorityMuxer::prioritiesChanged, this, [=] (int priority){
-		const PriorityMuxer::InputInfo priorityInfo = _prioMuxer->getInputInfo(priority);
+		const PriorityMuxer::InputInfo& priorityInfo = _prioMuxer->getInputInfo(priority);
 		int smooth_cfg = priorityInfo.smooth_cfg;
 		if (smooth_cfg != _currentConfigId || smooth_cfg == SmoothingConfigID::EFFECT_DYNAMIC)
 		{
@@ -149,10 +150,11 @@ void LinearColorSmoothing::handleSettingsUpdate(settings::type type, const QJson
 	}
 }
 
-int LinearColorSmoothing::write(const std::vector<ColorRgb> &ledValues)
+int LinearColorSmoothing::write(const std::vector<ColorRgb> &ledValues, const ImageMetadata &metadata)
 {
 	_targetTime = micros() + (MS_PER_MICRO * _settlingTime);
 	_targetValues = ledValues;
+	_targetMetadata = metadata;
 
 	rememberFrame(ledValues);
 
@@ -173,7 +175,7 @@ int LinearColorSmoothing::write(const std::vector<ColorRgb> &ledValues)
 	return 0;
 }
 
-int LinearColorSmoothing::updateLedValues(const std::vector<ColorRgb> &ledValues)
+int LinearColorSmoothing::updateLedValues(const std::vector<ColorRgb> &ledValues, const ImageMetadata &metadata)
 {
 	int retval = 0;
 	if (!_enabled)
@@ -182,7 +184,7 @@ int LinearColorSmoothing::updateLedValues(const std::vector<ColorRgb> &ledValues
 	}
 	else
 	{
-		retval = write(ledValues);
+		retval = write(ledValues, metadata);
 	}
 	return retval;
 }
@@ -517,18 +519,22 @@ void LinearColorSmoothing::queueColors(const std::vector<ColorRgb> &ledColors)
 {
 	assert (ledColors.size() > 0);
 
+	// The latency of a target is measured up to the first frame approaching it
+	const qint64 captureTime = _targetMetadata.captureTime;
+	_targetMetadata.captureTime = 0;
+
 	if (_outputDelay == 0)
 	{
 		// No output delay => immediate write
 		if (!_pause)
 		{
-			emit _hyperion->ledDeviceData(ledColors);
+			emit _hyperion->ledDeviceData(ledColors, captureTime);
 		}
 	}
 	else
 	{
 		// Push new colors in the delay-buffer
-		_outputQueue.push_back(ledColors);
+		_outputQueue.emplace_back(ledColors, captureTime);
 
 		// If the delay-buffer is filled pop the front and write to device
 		if (!_outputQueue.empty())
@@ -537,7 +543,7 @@ void LinearColorSmoothing::queueColors(const std::vector<ColorRgb> &ledColors)
 			{
 				if (!_pause)
 				{
-					emit _hyperion->ledDeviceData(_outputQueue.front());
+					emit _hyperion->ledDeviceData(_outputQueue.front().first, _outputQueue.front().second);
 				}
 				_outputQueue.pop_front();
 			}
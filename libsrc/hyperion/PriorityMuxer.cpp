@@ -31,6 +31,7 @@ PriorityMuxer::PriorityMuxer(int ledCount, QObject * parent)
 	  , _updateTimer(new QTimer(this))
 	  , _timer(new QTimer(this))
 	  , _blockTimer(new QTimer(this))
+	  , _imageSlots(new ImageSlotTable(PriorityMuxer::LOWEST_PRIORITY))
 {
 	QString subComponent = parent->property("instance").toString();
 	_log= Logger::getInstance("MUXER", subComponent);
@@ -128,7 +129,7 @@ bool PriorityMuxer::hasPriority(int priority) const
 	return (priority == PriorityMuxer::LOWEST_PRIORITY) ? true : _activeInputs.contains(priority);
 }
 
-PriorityMuxer::InputInfo PriorityMuxer::getInputInfo(int priority) const
+const PriorityMuxer::InputInfo& PriorityMuxer::getInputInfo(int priority) const
 {
 	auto elemIt = _activeInputs.constFind(priority);
 	if (elemIt == _activeInputs.end())
@@ -165,6 +166,9 @@ void PriorityMuxer::registerInput(int priority, hyperion::Components component,
 		}
 	}
 
+	// producers may publish images of the priority from now on
+	_imageSlots->create(priority);
+
 	InputInfo& input     = _activeInputs[priority];
 	input.priority       = priority;
 	input.timeoutTime_ms = newInput ? TIMEOUT_NOT_ACTIVE_PRIO : input.timeoutTime_ms;
@@ -175,6 +179,8 @@ void PriorityMuxer::registerInput(int priority, hyperion::Components component,
 
 	if (newInput)
 	{
+		input.metadata      = ImageMetadata();
+		input.skippedFrames = 0;
 		Debug(_log,"Register new input '%s/%s' (%s) with priority %d as inactive", QSTRING_CSTR(origin), hyperion::componentToIdString(component), QSTRING_CSTR(owner), priority);
 	}
 	else
@@ -233,6 +239,7 @@ bool PriorityMuxer::setInput(int priority, const std::vector<ColorRgb>& ledColor
 	input.timeoutTime_ms = timeout_ms;
 	input.ledColors      = ledColors;
 	input.image.clear();
+	input.metadata       = ImageMetadata();
 
 	// emit active change
 	if(activeChange)
@@ -283,6 +290,8 @@ bool PriorityMuxer::setInputImage(int priority, const Image<ColorRgb>& image, in
 	// update input
 	input.timeoutTime_ms = timeout_ms;
 	input.image          = image;
+	input.skippedFrames += image.metadata().skippedSince(input.metadata);
+	input.metadata       = image.metadata();
 	input.ledColors.clear();
 
 	// emit active change
@@ -305,10 +314,18 @@ bool PriorityMuxer::setInputInactive(int priority)
 	return setInputImage(priority, image, TIMEOUT_NOT_ACTIVE_PRIO);
 }
 
+QSharedPointer<PriorityMuxer::ImageSlotTable> PriorityMuxer::getImageSlotTable() const
+{
+	return _imageSlots;
+}
+
 bool PriorityMuxer::clearInput(int priority)
 {
 	if (priority < PriorityMuxer::LOWEST_PRIORITY)
 	{
+		// images published before must not set the cleared priority again
+		_imageSlots->discard(priority);
+
 		_activeInputs[priority].timeoutTime_ms = REMOVE_CLEARED_PRIO;
 		return true;
 	}
@@ -321,6 +338,10 @@ void PriorityMuxer::clearAll(bool forceClearAll)
 	{
 		_previousPriority = _currentPriority;
 		_activeInputs.clear();
+		for (int priority = 0; priority < PriorityMuxer::LOWEST_PRIORITY; ++priority)
+		{
+			_imageSlots->discard(priority);
+		}
 		_currentPriority = PriorityMuxer::LOWEST_PRIORITY;
 		_activeInputs[_currentPriority] = _lowestPriorityInfo;
 		updatePriorities();
@@ -329,7 +350,7 @@ void PriorityMuxer::clearAll(bool forceClearAll)
 	{
 		for(auto key : _activeInputs.keys())
 		{
-			const InputInfo info = getInputInfo(key);
+			const InputInfo& info = getInputInfo(key);
 			if ((info.componentId == hyperion::COMP_COLOR || info.componentId == hyperion::COMP_EFFECT || info.componentId == hyperion::COMP_IMAGE) && key < PriorityMuxer::LOWEST_PRIORITY-1)
 			{
 				clearInput(key);
@@ -11,6 +11,7 @@
 
 #include "hyperion/Hyperion.h"
 #include <utils/JsonUtils.h>
+#include <utils/LatencyStatistics.h>
 
 //std includes
 #include <sstream>
@@ -302,7 +303,7 @@ void LedDevice::stopEnableAttemptsTimer()
 	}
 }
 
-int LedDevice::updateLeds(std::vector<ColorRgb> ledValues)
+int LedDevice::updateLeds(std::vector<ColorRgb> ledValues, qint64 captureTime)
 {
 	int retval = 0;
 	if (!_isEnabled || !_isOn || !_isDeviceReady || _isDeviceInError)
@@ -318,6 +319,11 @@ int LedDevice::updateLeds(std::vector<ColorRgb> ledValues)
 			retval = write(ledValues);
 			_lastWriteTime = QDateTime::currentDateTime();
 
+			if (retval >= 0)
+			{
+				LatencyStatistics::getInstance().addSample(captureTime);
+			}
+
 			// if device requires refreshing, save Led-Values and restart the timer
 			if (_isRefreshEnabled && _isEnabled)
 			{
@@ -135,6 +135,7 @@ void ProtoClientConnection::handleColorCommand(const proto::ColorRequest &messag
 		emit clearGlobalInput(_priority);
 		emit registerGlobalInput(priority, hyperion::COMP_PROTOSERVER, "Proto@"+_clientAddress);
 		_priority = priority;
+		_throttle.setPriority(_priority);
 	}
 
 	// set output
@@ -166,6 +167,7 @@ void ProtoClientConnection::handleImageCommand(const proto::ImageRequest &messag
 		emit clearGlobalInput(_priority);
 		emit registerGlobalInput(priority, hyperion::COMP_PROTOSERVER, "Proto@"+_clientAddress);
 		_priority = priority;
+		_throttle.setPriority(_priority);
 	}
 
 	if (width <= 0 || height <= 0)
@@ -182,6 +184,13 @@ void ProtoClientConnection::handleImageCommand(const proto::ImageRequest &messag
 		return;
 	}
 
+	// images hidden behind a higher priority are forwarded at the keep-alive rate only
+	if (!_throttle.isFrameDue(duration))
+	{
+		sendSuccessReply();
+		return;
+	}
+
 	// create ImageRgb
 	Image<ColorRgb> imageRGB(width, height);
 	if (channelCount == 3)
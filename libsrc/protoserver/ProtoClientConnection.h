@@ -11,6 +11,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/ColorRgba.h>
 #include <utils/Components.h>
+#include <utils/InputThrottle.h>
 
 class QTcpSocket;
 class QTimer;
@@ -72,6 +73,13 @@ public slots:
 	///
 	void registationRequired(int priority) { if (_priority == priority) _priority = -1; };
 
+	///
+	/// @brief Update the visible priority of an instance, images hidden behind a higher priority are throttled
+	/// @param hyperionInd  The instance index
+	/// @param priority     The visible priority, -1 when the instance stopped
+	///
+	void handleVisiblePriorityChange(int hyperionInd, int priority) { _throttle.setVisiblePriority(hyperionInd, priority); }
+
 	///
 	/// @brief close the socket and call disconnected()
 	///
@@ -159,6 +167,9 @@ private:
 	int _timeout;
 	int _priority;
 
+	/// Throttles the images, while they are hidden behind a higher priority on all instances
+	InputThrottle _throttle;
+
 	/// The buffer used for reading data from the socket
 	QByteArray _receiveBuffer;
 };
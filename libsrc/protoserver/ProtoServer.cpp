@@ -82,6 +82,7 @@ void ProtoServer::newConnection()
 				connect(client, &ProtoClientConnection::setGlobalInputColor, GlobalSignals::getInstance(), &GlobalSignals::setGlobalColor);
 				connect(client, &ProtoClientConnection::setBufferImage, GlobalSignals::getInstance(), &GlobalSignals::setBufferImage);
 				connect(GlobalSignals::getInstance(), &GlobalSignals::globalRegRequired, client, &ProtoClientConnection::registationRequired);
+				connect(GlobalSignals::getInstance(), &GlobalSignals::visiblePriorityChanged, client, &ProtoClientConnection::handleVisiblePriorityChange);
 				_openConnections.append(client);
 			}
 			else
@@ -0,0 +1,104 @@
+#include <utils/FrameBufferPool.h>
+
+#include <QMutexLocker>
+
+FrameBufferPool::FrameBufferPool()
+	: _statistics{0, 0, 0, 0, 0, 0, 0}
+{
+}
+
+FrameBufferPool& FrameBufferPool::getInstance()
+{
+	// Never destroyed, images with static storage duration may release their buffers during shutdown
+	static FrameBufferPool* instance = new FrameBufferPool();
+	return *instance;
+}
+
+size_t FrameBufferPool::bufferSize(size_t size)
+{
+	return (qMax(size, size_t(1)) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void* FrameBufferPool::acquire(size_t size)
+{
+	const size_t bytes = bufferSize(size);
+	{
+		QMutexLocker lock(&_mutex);
+		++_statistics.acquired;
+
+		auto freeBuffers = _freeBuffers.find(bytes);
+		if (freeBuffers != _freeBuffers.end() && !freeBuffers->second.empty())
+		{
+			void* buffer = freeBuffers->second.back();
+			freeBuffers->second.pop_back();
+			++_statistics.reused;
+			--_statistics.freeBuffers;
+			_statistics.freeBytes -= bytes;
+			return buffer;
+		}
+	}
+
+	void* buffer = qMallocAligned(bytes, ALIGNMENT);
+	Q_CHECK_PTR(buffer);
+	return buffer;
+}
+
+void FrameBufferPool::release(void* buffer, size_t size)
+{
+	if (buffer == nullptr)
+	{
+		return;
+	}
+
+	const size_t bytes = bufferSize(size);
+	{
+		QMutexLocker lock(&_mutex);
+		++_statistics.released;
+
+		if (_statistics.freeBytes + bytes <= MAX_FREE_BYTES)
+		{
+			std::vector<void*>& freeBuffers = _freeBuffers[bytes];
+			if (freeBuffers.size() < MAX_FREE_BUFFERS_PER_SIZE)
+			{
+				// Reserve once, so returning buffers does not allocate either
+				freeBuffers.reserve(MAX_FREE_BUFFERS_PER_SIZE);
+				freeBuffers.push_back(buffer);
+				++_statistics.freeBuffers;
+				_statistics.freeBytes += bytes;
+				return;
+			}
+		}
+
+		++_statistics.discarded;
+	}
+
+	qFreeAligned(buffer);
+}
+
+void FrameBufferPool::countCopy()
+{
+	QMutexLocker lock(&_mutex);
+	++_statistics.copies;
+}
+
+void FrameBufferPool::clear()
+{
+	QMutexLocker lock(&_mutex);
+
+	for (auto& freeBuffers : _freeBuffers)
+	{
+		for (void* buffer : freeBuffers.second)
+		{
+			qFreeAligned(buffer);
+		}
+	}
+	_freeBuffers.clear();
+	_statistics.freeBuffers = 0;
+	_statistics.freeBytes = 0;
+}
+
+FrameBufferPool::Statistics FrameBufferPool::statistics() const
+{
+	QMutexLocker lock(&_mutex);
+	return _statistics;
+}
@@ -0,0 +1,64 @@
+#include <utils/FrameDecoderStatistics.h>
+
+#include <QMutexLocker>
+
+FrameDecoderStatistics::FrameDecoderStatistics()
+	: _statistics{0, 0, 0, 0, 0, {}}
+{
+}
+
+FrameDecoderStatistics& FrameDecoderStatistics::getInstance()
+{
+	static FrameDecoderStatistics* instance = new FrameDecoderStatistics();
+	return *instance;
+}
+
+void FrameDecoderStatistics::setThreads(quint32 threads)
+{
+	QMutexLocker lock(&_mutex);
+	_statistics.threads = threads;
+}
+
+void FrameDecoderStatistics::countDecoded(bool success)
+{
+	QMutexLocker lock(&_mutex);
+	if (success)
+	{
+		++_statistics.decoded;
+	}
+	else
+	{
+		++_statistics.failed;
+	}
+}
+
+void FrameDecoderStatistics::countDropped()
+{
+	QMutexLocker lock(&_mutex);
+	++_statistics.dropped;
+}
+
+void FrameDecoderStatistics::countReordered()
+{
+	QMutexLocker lock(&_mutex);
+	++_statistics.reordered;
+}
+
+void FrameDecoderStatistics::countMjpegDecoded(int scaleDenominator, qint64 nsecs)
+{
+	int scale = 0;
+	while (scale < MJPEG_SCALES - 1 && (1 << scale) < scaleDenominator)
+	{
+		++scale;
+	}
+
+	QMutexLocker lock(&_mutex);
+	++_statistics.mjpeg[scale].frames;
+	_statistics.mjpeg[scale].nsecs += static_cast<quint64>(qMax(nsecs, qint64(0)));
+}
+
+FrameDecoderStatistics::Statistics FrameDecoderStatistics::statistics() const
+{
+	QMutexLocker lock(&_mutex);
+	return _statistics;
+}
@@ -2,6 +2,278 @@
 #include <utils/ColorSys.h>
 #include <utils/Logger.h>
 
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define IMAGERESAMPLER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define IMAGERESAMPLER_NEON
+#endif
+
+namespace {
+
+///
+/// Converts rows of Y, U and V samples to RGB, equal to ColorSys::yuv2rgb per pixel
+///
+void yuvToRgbRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int count, ColorRgb* rgb)
+{
+	int idx = 0;
+
+#if defined(IMAGERESAMPLER_SSE2)
+	// 8 pixels per iteration; products of (c,e), (c,d) and (e,1) pairs are summed to 32 bit by _mm_madd_epi16
+	const __m128i zero      = _mm_setzero_si128();
+	const __m128i one       = _mm_set1_epi16(1);
+	const __m128i offsetY   = _mm_set1_epi16(16);
+	const __m128i offsetUV  = _mm_set1_epi16(128);
+	const __m128i rounding  = _mm_set1_epi32(128);
+	const __m128i factorsR  = _mm_setr_epi16(298, 409, 298, 409, 298, 409, 298, 409);
+	const __m128i factorsG1 = _mm_setr_epi16(298, -100, 298, -100, 298, -100, 298, -100);
+	const __m128i factorsG2 = _mm_setr_epi16(-208, 128, -208, 128, -208, 128, -208, 128);
+	const __m128i factorsB  = _mm_setr_epi16(298, 516, 298, 516, 298, 516, 298, 516);
+
+	alignas(16) uint8_t channels[32];
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const __m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + idx)), zero), offsetY);
+		const __m128i d = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + idx)), zero), offsetUV);
+		const __m128i e = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + idx)), zero), offsetUV);
+
+		const __m128i ceLo = _mm_unpacklo_epi16(c, e);
+		const __m128i ceHi = _mm_unpackhi_epi16(c, e);
+		const __m128i cdLo = _mm_unpacklo_epi16(c, d);
+		const __m128i cdHi = _mm_unpackhi_epi16(c, d);
+		const __m128i e1Lo = _mm_unpacklo_epi16(e, one);
+		const __m128i e1Hi = _mm_unpackhi_epi16(e, one);
+
+		const __m128i r = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceLo, factorsR), rounding), 8),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceHi, factorsR), rounding), 8));
+		const __m128i g = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdLo, factorsG1), _mm_madd_epi16(e1Lo, factorsG2)), 8),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdHi, factorsG1), _mm_madd_epi16(e1Hi, factorsG2)), 8));
+		const __m128i b = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdLo, factorsB), rounding), 8),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdHi, factorsB), rounding), 8));
+
+		// Saturating packs clamp to [0, 255]
+		_mm_store_si128(reinterpret_cast<__m128i*>(channels), _mm_packus_epi16(r, g));
+		_mm_store_si128(reinterpret_cast<__m128i*>(channels + 16), _mm_packus_epi16(b, zero));
+
+		ColorRgb* out = rgb + idx;
+		for (int k = 0; k < 8; ++k)
+		{
+			out[k].red   = channels[k];
+			out[k].green = channels[8 + k];
+			out[k].blue  = channels[16 + k];
+		}
+	}
+#elif defined(IMAGERESAMPLER_NEON)
+	// 8 pixels per iteration; vqrshrn adds the rounding constant, shifts and saturates in one step
+	const int16x8_t offsetY  = vdupq_n_s16(16);
+	const int16x8_t offsetUV = vdupq_n_s16(128);
+
+	for (; idx + 8 <= count; idx += 8)
+	{
+		const int16x8_t c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + idx))), offsetY);
+		const int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + idx))), offsetUV);
+		const int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + idx))), offsetUV);
+
+		const int32x4_t cLo = vmull_n_s16(vget_low_s16(c), 298);
+		const int32x4_t cHi = vmull_n_s16(vget_high_s16(c), 298);
+
+		const int16x8_t r = vcombine_s16(
+			vqrshrn_n_s32(vmlal_n_s16(cLo, vget_low_s16(e), 409), 8),
+			vqrshrn_n_s32(vmlal_n_s16(cHi, vget_high_s16(e), 409), 8));
+		const int16x8_t g = vcombine_s16(
+			vqrshrn_n_s32(vmlal_n_s16(vmlal_n_s16(cLo, vget_low_s16(d), -100), vget_low_s16(e), -208), 8),
+			vqrshrn_n_s32(vmlal_n_s16(vmlal_n_s16(cHi, vget_high_s16(d), -100), vget_high_s16(e), -208), 8));
+		const int16x8_t b = vcombine_s16(
+			vqrshrn_n_s32(vmlal_n_s16(cLo, vget_low_s16(d), 516), 8),
+			vqrshrn_n_s32(vmlal_n_s16(cHi, vget_high_s16(d), 516), 8));
+
+		uint8x8x3_t pixels;
+		pixels.val[0] = vqmovun_s16(r);
+		pixels.val[1] = vqmovun_s16(g);
+		pixels.val[2] = vqmovun_s16(b);
+		vst3_u8(reinterpret_cast<uint8_t*>(rgb + idx), pixels);
+	}
+#endif
+
+	for (; idx < count; ++idx)
+	{
+		ColorSys::yuv2rgb(y[idx], u[idx], v[idx], rgb[idx].red, rgb[idx].green, rgb[idx].blue);
+	}
+}
+
+///
+/// Pixel formats, providing the samples of one pixel of a source row
+///
+struct Uyvy
+{
+	static void sample(const uint8_t* data, const ImageResampler::SourceRow& row, int x, uint8_t& y, uint8_t& u, uint8_t& v)
+	{
+		const uint8_t* line = data + row.yOffset;
+		const uint8_t* pair = line + ((x >> 1) << 2);
+		y = line[(x << 1) + 1];
+		u = pair[0];
+		v = pair[2];
+	}
+};
+
+struct Yuyv
+{
+	static void sample(const uint8_t* data, const ImageResampler::SourceRow& row, int x, uint8_t& y, uint8_t& u, uint8_t& v)
+	{
+		const uint8_t* line = data + row.yOffset;
+		const uint8_t* pair = line + ((x >> 1) << 2);
+		y = line[x << 1];
+		u = pair[1];
+		v = pair[3];
+	}
+};
+
+struct Nv12
+{
+	static void sample(const uint8_t* data, const ImageResampler::SourceRow& row, int x, uint8_t& y, uint8_t& u, uint8_t& v)
+	{
+		const uint8_t* uv = data + row.uOffset + ((x >> 1) << 1);
+		y = data[row.yOffset + x];
+		u = uv[0];
+		v = uv[1];
+	}
+};
+
+struct I420
+{
+	static void sample(const uint8_t* data, const ImageResampler::SourceRow& row, int x, uint8_t& y, uint8_t& u, uint8_t& v)
+	{
+		y = data[row.yOffset + x];
+		u = data[row.uOffset + (x >> 1)];
+		v = data[row.vOffset + (x >> 1)];
+	}
+};
+
+struct Bgr16
+{
+	static void pixel(const uint8_t* data, const ImageResampler::SourceRow& row, int x, ColorRgb& rgb)
+	{
+		const uint8_t* pixel = data + row.yOffset + (x << 1);
+		rgb.blue  = (pixel[0] & 0x1f) << 3;
+		rgb.green = (((pixel[1] & 0x7) << 3) | (pixel[0] & 0xE0) >> 5) << 2;
+		rgb.red   = (pixel[1] & 0xF8);
+	}
+};
+
+struct Bgr24
+{
+	static void pixel(const uint8_t* data, const ImageResampler::SourceRow& row, int x, ColorRgb& rgb)
+	{
+		const uint8_t* pixel = data + row.yOffset + (x << 1) + x;
+		rgb.blue  = pixel[0];
+		rgb.green = pixel[1];
+		rgb.red   = pixel[2];
+	}
+};
+
+struct Rgb32
+{
+	static void pixel(const uint8_t* data, const ImageResampler::SourceRow& row, int x, ColorRgb& rgb)
+	{
+		const uint8_t* pixel = data + row.yOffset + (x << 2);
+		rgb.red   = pixel[0];
+		rgb.green = pixel[1];
+		rgb.blue  = pixel[2];
+	}
+};
+
+struct Bgr32
+{
+	static void pixel(const uint8_t* data, const ImageResampler::SourceRow& row, int x, ColorRgb& rgb)
+	{
+		const uint8_t* pixel = data + row.yOffset + (x << 2);
+		rgb.blue  = pixel[0];
+		rgb.green = pixel[1];
+		rgb.red   = pixel[2];
+	}
+};
+
+///
+/// Gathers the Y, U and V samples of the given columns of a row into the planar sample rows
+///
+template <typename Format_T>
+void gatherYuvRow(const uint8_t* data, const ImageResampler::SourceRow& row, const int* columns, int count, uint8_t* samples, ColorRgb* /*rgb*/)
+{
+	uint8_t* y = samples;
+	uint8_t* u = y + count;
+	uint8_t* v = u + count;
+	for (int idx = 0; idx < count; ++idx)
+	{
+		Format_T::sample(data, row, columns[idx], y[idx], u[idx], v[idx]);
+	}
+}
+
+///
+/// Converts the given columns of a row of a YUV format
+///
+template <typename Format_T>
+void convertYuvRow(const uint8_t* data, const ImageResampler::SourceRow& row, const int* columns, int count, uint8_t* samples, ColorRgb* rgb)
+{
+	gatherYuvRow<Format_T>(data, row, columns, count, samples, rgb);
+	yuvToRgbRow(samples, samples + count, samples + 2 * count, count, rgb);
+}
+
+///
+/// Converts the given columns of a row of an RGB format
+///
+template <typename Format_T>
+void convertRgbRow(const uint8_t* data, const ImageResampler::SourceRow& row, const int* columns, int count, uint8_t* /*samples*/, ColorRgb* rgb)
+{
+	for (int idx = 0; idx < count; ++idx)
+	{
+		Format_T::pixel(data, row, columns[idx], rgb[idx]);
+	}
+}
+
+/// Maximum number of rows summed up per column in 16 bit (255 * 257 = 65535)
+constexpr int MAX_ROWS_PER_COLUMN_SUM = 257;
+
+///
+/// Adds the bytes of a row to the given 16 bit sums
+///
+void accumulateRow(const uint8_t* row, uint16_t* sums, int count)
+{
+	int idx = 0;
+
+#if defined(IMAGERESAMPLER_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; idx + 16 <= count; idx += 16)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + idx));
+		__m128i* sumsLo = reinterpret_cast<__m128i*>(sums + idx);
+		__m128i* sumsHi = reinterpret_cast<__m128i*>(sums + idx + 8);
+		_mm_storeu_si128(sumsLo, _mm_add_epi16(_mm_loadu_si128(sumsLo), _mm_unpacklo_epi8(bytes, zero)));
+		_mm_storeu_si128(sumsHi, _mm_add_epi16(_mm_loadu_si128(sumsHi), _mm_unpackhi_epi8(bytes, zero)));
+	}
+#elif defined(IMAGERESAMPLER_NEON)
+	for (; idx + 16 <= count; idx += 16)
+	{
+		const uint8x16_t bytes = vld1q_u8(row + idx);
+		vst1q_u16(sums + idx, vaddw_u8(vld1q_u16(sums + idx), vget_low_u8(bytes)));
+		vst1q_u16(sums + idx + 8, vaddw_u8(vld1q_u16(sums + idx + 8), vget_high_u8(bytes)));
+	}
+#endif
+
+	for (; idx < count; ++idx)
+	{
+		sums[idx] = static_cast<uint16_t>(sums[idx] + row[idx]);
+	}
+}
+
+} // end anonymous namespace
+
 ImageResampler::ImageResampler()
 	: _horizontalDecimation(8)
 	, _verticalDecimation(8)
@@ -11,7 +283,10 @@ ImageResampler::ImageResampler()
 	, _cropBottom(0)
 	, _videoMode(VideoMode::VIDEO_2D)
 	, _flipMode(FlipMode::NO_CHANGE)
+	, _pixelDecimationAveraging(false)
+	, _plan()
 {
+	_plan.pixelFormat = PixelFormat::NO_CHANGE;
 }
 
 void ImageResampler::setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom)
@@ -22,16 +297,70 @@ void ImageResampler::setCropping(int cropLeft, int cropRight, int cropTop, int c
 	_cropBottom = cropBottom;
 }
 
-void ImageResampler::processImage(const uint8_t * data, int width, int height, int lineLength, PixelFormat pixelFormat, Image<ColorRgb> &outputImage) const
+bool ImageResampler::isPlannedFor(int width, int height, int lineLength, PixelFormat pixelFormat) const
+{
+	return _plan.width == width && _plan.height == height && _plan.lineLength == lineLength && _plan.pixelFormat == pixelFormat
+		&& _plan.horizontalDecimation == _horizontalDecimation && _plan.verticalDecimation == _verticalDecimation
+		&& _plan.cropLeft == _cropLeft && _plan.cropRight == _cropRight && _plan.cropTop == _cropTop && _plan.cropBottom == _cropBottom
+		&& _plan.videoMode == _videoMode && _plan.flipMode == _flipMode && _plan.averaging == _pixelDecimationAveraging;
+}
+
+void ImageResampler::buildPlan(int width, int height, int lineLength, PixelFormat pixelFormat) const
 {
+	Plan& plan = _plan;
+	plan.width = width;
+	plan.height = height;
+	plan.lineLength = lineLength;
+	plan.pixelFormat = pixelFormat;
+	plan.horizontalDecimation = _horizontalDecimation;
+	plan.verticalDecimation = _verticalDecimation;
+	plan.cropLeft = _cropLeft;
+	plan.cropRight = _cropRight;
+	plan.cropTop = _cropTop;
+	plan.cropBottom = _cropBottom;
+	plan.videoMode = _videoMode;
+	plan.flipMode = _flipMode;
+	plan.averaging = _pixelDecimationAveraging && (_horizontalDecimation > 1 || _verticalDecimation > 1);
+
+	// select the row kernels
+	plan.convertRow = nullptr;
+	plan.gatherRow = nullptr;
+	switch (pixelFormat)
+	{
+		case PixelFormat::UYVY:
+			plan.convertRow = convertYuvRow<Uyvy>;
+			plan.gatherRow = gatherYuvRow<Uyvy>;
+			break;
+		case PixelFormat::YUYV:
+			plan.convertRow = convertYuvRow<Yuyv>;
+			plan.gatherRow = gatherYuvRow<Yuyv>;
+			break;
+		case PixelFormat::NV12:
+			plan.convertRow = convertYuvRow<Nv12>;
+			plan.gatherRow = gatherYuvRow<Nv12>;
+			break;
+		case PixelFormat::I420:
+			plan.convertRow = convertYuvRow<I420>;
+			plan.gatherRow = gatherYuvRow<I420>;
+			break;
+		case PixelFormat::BGR16: plan.convertRow = convertRgbRow<Bgr16>; break;
+		case PixelFormat::BGR24: plan.convertRow = convertRgbRow<Bgr24>; break;
+		case PixelFormat::RGB32: plan.convertRow = convertRgbRow<Rgb32>; break;
+		case PixelFormat::BGR32: plan.convertRow = convertRgbRow<Bgr32>; break;
+#ifdef HAVE_TURBO_JPEG
+		case PixelFormat::MJPEG:
+			break;
+#endif
+		case PixelFormat::NO_CHANGE:
+			Error(Logger::getInstance("ImageResampler"), "Invalid pixel format given");
+			break;
+	}
+
 	int cropLeft = _cropLeft;
 	int cropRight  = _cropRight;
 	int cropTop = _cropTop;
 	int cropBottom = _cropBottom;
 
-	int xDestFlip = 0, yDestFlip = 0;
-	int uOffset = 0, vOffset = 0;
-
 	// handle 3D mode
 	switch (_videoMode)
 	{
@@ -48,125 +377,181 @@ void ImageResampler::processImage(const uint8_t * data, int width, int height, i
 	}
 
 	// calculate the output size
-	int outputWidth = (width - cropLeft - cropRight - (_horizontalDecimation >> 1) + _horizontalDecimation - 1) / _horizontalDecimation;
-	int outputHeight = (height - cropTop - cropBottom - (_verticalDecimation >> 1) + _verticalDecimation - 1) / _verticalDecimation;
-
-	outputImage.resize(outputWidth, outputHeight);
+	plan.outputWidth = (width - cropLeft - cropRight - (_horizontalDecimation >> 1) + _horizontalDecimation - 1) / _horizontalDecimation;
+	plan.outputHeight = (height - cropTop - cropBottom - (_verticalDecimation >> 1) + _verticalDecimation - 1) / _verticalDecimation;
 
-	for (int yDest = 0, ySource = cropTop + (_verticalDecimation >> 1); yDest < outputHeight; ySource += _verticalDecimation, ++yDest)
+	plan.rows.clear();
+	plan.columns.clear();
+	if (plan.convertRow == nullptr || plan.outputWidth <= 0 || plan.outputHeight <= 0)
 	{
-		int yOffset = lineLength * ySource;
+		return;
+	}
+
+	// HORIZONTAL flips the rows, VERTICAL the columns
+	const bool flipRows = (_flipMode == FlipMode::HORIZONTAL || _flipMode == FlipMode::BOTH);
+	const bool flipColumns = (_flipMode == FlipMode::VERTICAL || _flipMode == FlipMode::BOTH);
+
+	auto sourceRow = [&](int ySource, int yDest) {
+		SourceRow row;
+		row.yOffset = lineLength * ySource;
+		row.uOffset = 0;
+		row.vOffset = 0;
 		if (pixelFormat == PixelFormat::NV12)
 		{
-			uOffset = (height + ySource / 2) * lineLength;
+			row.uOffset = (height + ySource / 2) * lineLength;
 		}
 		else if (pixelFormat == PixelFormat::I420)
 		{
-			uOffset = width * height + (ySource/2) * width/2;
-			vOffset = width * height * 1.25 + (ySource/2) * width/2;
+			row.uOffset = width * height + (ySource/2) * width/2;
+			row.vOffset = width * height + (width * height) / 4 + (ySource/2) * width/2;
 		}
+		row.destination = static_cast<size_t>(flipRows ? plan.outputHeight - yDest - 1 : yDest) * static_cast<size_t>(plan.outputWidth);
+		return row;
+	};
+
+	if (plan.averaging)
+	{
+		// All rows and columns of the decimation blocks, the destination is the output row of the row's block
+		const int usedHeight = qMin(height - cropTop - cropBottom, plan.outputHeight * _verticalDecimation);
+		const int usedWidth = qMin(width - cropLeft - cropRight, plan.outputWidth * _horizontalDecimation);
 
-		for (int xDest = 0, xSource = cropLeft + (_horizontalDecimation >> 1); xDest < outputWidth; xSource += _horizontalDecimation, ++xDest)
+		plan.rows.reserve(static_cast<size_t>(usedHeight));
+		for (int ySource = 0; ySource < usedHeight; ++ySource)
 		{
-			switch (_flipMode)
-			{
-				case FlipMode::HORIZONTAL:
-
-					xDestFlip = xDest;
-					yDestFlip = outputHeight-yDest-1;
-					break;
-				case FlipMode::VERTICAL:
-					xDestFlip = outputWidth-xDest-1;
-					yDestFlip = yDest;
-					break;
-				case FlipMode::BOTH:
-					xDestFlip = outputWidth-xDest-1;
-					yDestFlip = outputHeight-yDest-1;
-					break;
-				case FlipMode::NO_CHANGE:
-					xDestFlip = xDest;
-					yDestFlip = yDest;
-					break;
-			}
+			plan.rows.push_back(sourceRow(cropTop + ySource, ySource / _verticalDecimation));
+		}
+
+		plan.columns.reserve(static_cast<size_t>(usedWidth));
+		for (int xSource = 0; xSource < usedWidth; ++xSource)
+		{
+			plan.columns.push_back(cropLeft + xSource);
+		}
+
+		plan.samples.resize(3 * static_cast<size_t>(usedWidth));
+		plan.columnSums.resize(3 * static_cast<size_t>(usedWidth));
+		plan.blockSums.resize(3 * static_cast<size_t>(plan.outputWidth));
+		plan.blockSamples.resize(3 * static_cast<size_t>(plan.outputWidth));
+		plan.flipColumns = flipColumns;
+	}
+	else
+	{
+		// One row per output row and the source column of each output pixel, flipping applied
+		plan.rows.reserve(static_cast<size_t>(plan.outputHeight));
+		for (int yDest = 0, ySource = cropTop + (_verticalDecimation >> 1); yDest < plan.outputHeight; ySource += _verticalDecimation, ++yDest)
+		{
+			plan.rows.push_back(sourceRow(ySource, yDest));
+		}
+
+		plan.columns.resize(static_cast<size_t>(plan.outputWidth));
+		for (int xDest = 0, xSource = cropLeft + (_horizontalDecimation >> 1); xDest < plan.outputWidth; xSource += _horizontalDecimation, ++xDest)
+		{
+			plan.columns[static_cast<size_t>(flipColumns ? plan.outputWidth - xDest - 1 : xDest)] = xSource;
+		}
+
+		plan.samples.resize(3 * static_cast<size_t>(plan.outputWidth));
+		plan.flipColumns = false;
+	}
+}
+
+void ImageResampler::processImage(const uint8_t * data, int width, int height, int lineLength, PixelFormat pixelFormat, Image<ColorRgb> &outputImage) const
+{
+	if (!isPlannedFor(width, height, lineLength, pixelFormat))
+	{
+		buildPlan(width, height, lineLength, pixelFormat);
+	}
+
+	Plan& plan = _plan;
+	outputImage.resize(plan.outputWidth, plan.outputHeight);
 
-			ColorRgb &rgb = outputImage(xDestFlip, yDestFlip);
-			switch (pixelFormat)
+	if (plan.rows.empty())
+	{
+		return;
+	}
+
+	ColorRgb* output = outputImage.memptr();
+
+	if (!plan.averaging)
+	{
+		for (const SourceRow& row : plan.rows)
+		{
+			plan.convertRow(data, row, plan.columns.data(), plan.outputWidth, plan.samples.data(), output + row.destination);
+		}
+		return;
+	}
+
+	// Sum up all source pixels per decimation block in a single pass over the rows.
+	// YUV samples are averaged before they are converted, i.e. converted once per block only.
+	const bool isYuv = (plan.gatherRow != nullptr);
+	const int croppedWidth = static_cast<int>(plan.columns.size());
+	const int outputWidth = plan.outputWidth;
+
+	// Samples are planar (Y, U, V) for YUV formats and interleaved RGB pixels otherwise
+	const int columnStride = isYuv ? 1 : 3;
+	const int channelStride = isYuv ? croppedWidth : 1;
+
+	for (size_t firstRow = 0; firstRow < plan.rows.size(); )
+	{
+		const size_t destination = plan.rows[firstRow].destination;
+		std::fill(plan.blockSums.begin(), plan.blockSums.end(), 0);
+
+		size_t endRow = firstRow;
+		while (endRow < plan.rows.size() && plan.rows[endRow].destination == destination)
+		{
+			// Sum up the rows per column, flushed to the block sums before the 16 bit sums could overflow
+			const size_t endBatch = qMin(endRow + MAX_ROWS_PER_COLUMN_SUM, plan.rows.size());
+			std::fill(plan.columnSums.begin(), plan.columnSums.end(), 0);
+			for (; endRow < endBatch && plan.rows[endRow].destination == destination; ++endRow)
 			{
-				case PixelFormat::UYVY:
-				{
-					int index = yOffset + (xSource << 1);
-					uint8_t y = data[index+1];
-					uint8_t u = ((xSource&1) == 0) ? data[index  ] : data[index-2];
-					uint8_t v = ((xSource&1) == 0) ? data[index+2] : data[index  ];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-				break;
-				case PixelFormat::YUYV:
+				if (isYuv)
 				{
-					int index = yOffset + (xSource << 1);
-					uint8_t y = data[index];
-					uint8_t u = ((xSource&1) == 0) ? data[index+1] : data[index-1];
-					uint8_t v = ((xSource&1) == 0) ? data[index+3] : data[index+1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
+					plan.gatherRow(data, plan.rows[endRow], plan.columns.data(), croppedWidth, plan.samples.data(), nullptr);
 				}
-				break;
-				case PixelFormat::BGR16:
+				else
 				{
-					int index = yOffset + (xSource << 1);
-					rgb.blue  = (data[index] & 0x1f) << 3;
-					rgb.green = (((data[index+1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2;
-					rgb.red   = (data[index+1] & 0xF8);
+					plan.convertRow(data, plan.rows[endRow], plan.columns.data(), croppedWidth, nullptr, reinterpret_cast<ColorRgb*>(plan.samples.data()));
 				}
-				break;
-				case PixelFormat::BGR24:
-				{
-					int index = yOffset + (xSource << 1) + xSource;
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
-				break;
-				case PixelFormat::RGB32:
-				{
-					int index = yOffset + (xSource << 2);
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
-				break;
-				case PixelFormat::BGR32:
-				{
-					int index = yOffset + (xSource << 2);
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
-				break;
-				case PixelFormat::NV12:
-				{
-					uint8_t y = data[yOffset + xSource];
-					uint8_t u = data[uOffset + ((xSource >> 1) << 1)];
-					uint8_t v = data[uOffset + ((xSource >> 1) << 1) + 1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-				break;
-				case PixelFormat::I420:
+				accumulateRow(plan.samples.data(), plan.columnSums.data(), 3 * croppedWidth);
+			}
+
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				const uint16_t* sums = plan.columnSums.data() + channel * channelStride;
+				uint32_t* blocks = plan.blockSums.data() + channel * outputWidth;
+				for (int xDest = 0; xDest < outputWidth; ++xDest)
 				{
-					int y = data[yOffset + xSource];
-					int u = data[uOffset + (xSource >> 1)];
-					int v = data[vOffset + (xSource >> 1)];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-					break;
+					const int endColumn = qMin((xDest + 1) * plan.horizontalDecimation, croppedWidth);
+					for (int column = xDest * plan.horizontalDecimation; column < endColumn; ++column)
+					{
+						blocks[xDest] += sums[column * columnStride];
+					}
 				}
-				break;
-#ifdef HAVE_TURBO_JPEG
-				case PixelFormat::MJPEG:
-				break;
-#endif
-				case PixelFormat::NO_CHANGE:
-					Error(Logger::getInstance("ImageResampler"), "Invalid pixel format given");
-				break;
 			}
 		}
+
+		ColorRgb* rgb = output + destination;
+		uint8_t* averages = isYuv ? plan.blockSamples.data() : reinterpret_cast<uint8_t*>(rgb);
+		const int averageColumnStride = isYuv ? 1 : 3;
+		const int averageChannelStride = isYuv ? outputWidth : 1;
+		const int rowCount = static_cast<int>(endRow - firstRow);
+		for (int xDest = 0; xDest < outputWidth; ++xDest)
+		{
+			const uint32_t pixelCount = static_cast<uint32_t>(rowCount * (qMin((xDest + 1) * plan.horizontalDecimation, croppedWidth) - xDest * plan.horizontalDecimation));
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				averages[xDest * averageColumnStride + channel * averageChannelStride] = static_cast<uint8_t>((plan.blockSums[static_cast<size_t>(channel * outputWidth + xDest)] + pixelCount / 2) / pixelCount);
+			}
+		}
+
+		if (isYuv)
+		{
+			yuvToRgbRow(plan.blockSamples.data(), plan.blockSamples.data() + outputWidth, plan.blockSamples.data() + 2 * outputWidth, outputWidth, rgb);
+		}
+
+		if (plan.flipColumns)
+		{
+			std::reverse(rgb, rgb + outputWidth);
+		}
+
+		firstRow = endRow;
 	}
 }
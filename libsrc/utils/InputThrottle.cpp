@@ -0,0 +1,71 @@
+#include <utils/InputThrottle.h>
+
+InputThrottle::InputThrottle()
+	: _priority(-1)
+	, _hidden(0)
+{
+}
+
+void InputThrottle::setPriority(int priority)
+{
+	_priority = priority;
+	evaluate();
+}
+
+void InputThrottle::setVisiblePriority(int instance, int visiblePriority)
+{
+	if (visiblePriority < 0)
+	{
+		_visiblePriorities.remove(instance);
+	}
+	else
+	{
+		_visiblePriorities.insert(instance, visiblePriority);
+	}
+	evaluate();
+}
+
+void InputThrottle::setHidden(bool hidden)
+{
+	_hidden = hidden ? 1 : 0;
+}
+
+bool InputThrottle::isHidden() const
+{
+	return int(_hidden) != 0;
+}
+
+bool InputThrottle::isFrameDue(int timeout_ms)
+{
+	if (!isHidden())
+	{
+		return true;
+	}
+
+	int interval = KEEP_ALIVE_INTERVAL_MS;
+	if (timeout_ms > 0)
+	{
+		interval = qMin(interval, timeout_ms / 2);
+	}
+
+	if (!_keepAliveTimer.isValid() || _keepAliveTimer.elapsed() >= interval)
+	{
+		_keepAliveTimer.start();
+		return true;
+	}
+	return false;
+}
+
+void InputThrottle::evaluate()
+{
+	bool hidden = _priority >= 0 && !_visiblePriorities.isEmpty();
+	for (int visiblePriority : _visiblePriorities)
+	{
+		if (visiblePriority >= _priority)
+		{
+			hidden = false;
+			break;
+		}
+	}
+	setHidden(hidden);
+}
@@ -0,0 +1,79 @@
+#include <utils/LatencyStatistics.h>
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+
+#include <QMutexLocker>
+
+LatencyStatistics::LatencyStatistics()
+	: _samples(0)
+	, _next(0)
+{
+	_window.reserve(WINDOW_SIZE);
+}
+
+LatencyStatistics& LatencyStatistics::getInstance()
+{
+	static LatencyStatistics* instance = new LatencyStatistics();
+	return *instance;
+}
+
+qint64 LatencyStatistics::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyStatistics::addSample(qint64 captureTime)
+{
+	if (captureTime <= 0)
+	{
+		return;
+	}
+
+	const qint64 latency = qMax(now() - captureTime, qint64(0));
+
+	QMutexLocker lock(&_mutex);
+	++_samples;
+	if (static_cast<int>(_window.size()) < WINDOW_SIZE)
+	{
+		_window.push_back(latency);
+	}
+	else
+	{
+		_window[static_cast<size_t>(_next)] = latency;
+	}
+	_next = (_next + 1) % WINDOW_SIZE;
+}
+
+LatencyStatistics::Statistics LatencyStatistics::statistics() const
+{
+	std::vector<qint64> latencies;
+	Statistics statistics {0, 0, 0.0, 0.0, 0.0, 0.0};
+	{
+		QMutexLocker lock(&_mutex);
+		statistics.samples = _samples;
+		latencies = _window;
+	}
+
+	if (latencies.empty())
+	{
+		return statistics;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	// Nearest rank percentile
+	const auto percentileMs = [&latencies](int percent) {
+		const size_t rank = (latencies.size() * static_cast<size_t>(percent) + 99) / 100;
+		return static_cast<double>(latencies[qMax(rank, size_t(1)) - 1]) / 1000000.0;
+	};
+
+	statistics.windowSamples = static_cast<quint32>(latencies.size());
+	statistics.p50Ms = percentileMs(50);
+	statistics.p95Ms = percentileMs(95);
+	statistics.p99Ms = percentileMs(99);
+	statistics.maxMs = static_cast<double>(latencies.back()) / 1000000.0;
+
+	return statistics;
+}
@@ -0,0 +1,103 @@
+#include <utils/WorkerPool.h>
+
+#include <QMutexLocker>
+
+WorkerPool::WorkerPool(int threadCount, const QString& name)
+	: _task(nullptr)
+	, _taskCount(0)
+	, _nextTask(0)
+	, _finishedTasks(0)
+	, _stopped(false)
+{
+	for (int idx = 1; idx < threadCount; ++idx)
+	{
+		std::unique_ptr<Worker> worker(new Worker(this));
+		worker->setObjectName(QString("%1-%2").arg(name).arg(idx));
+		worker->start();
+		_workers.push_back(std::move(worker));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		QMutexLocker lock(&_mutex);
+		_stopped = true;
+		_tasksAvailable.wakeAll();
+	}
+
+	for (const auto& worker : _workers)
+	{
+		worker->wait();
+	}
+}
+
+int WorkerPool::threadCount() const
+{
+	return static_cast<int>(_workers.size()) + 1;
+}
+
+void WorkerPool::run(int taskCount, const std::function<void(int)>& task)
+{
+	QMutexLocker jobLock(&_jobMutex);
+
+	if (_workers.empty() || taskCount <= 1)
+	{
+		for (int idx = 0; idx < taskCount; ++idx)
+		{
+			task(idx);
+		}
+		return;
+	}
+
+	QMutexLocker lock(&_mutex);
+	_task = &task;
+	_taskCount = taskCount;
+	_nextTask = 0;
+	_finishedTasks = 0;
+	_tasksAvailable.wakeAll();
+
+	// Take part in the execution
+	while (_nextTask < _taskCount)
+	{
+		const int idx = _nextTask++;
+		lock.unlock();
+		task(idx);
+		lock.relock();
+		++_finishedTasks;
+	}
+
+	// Wait for the tasks still executed by the workers
+	while (_finishedTasks < _taskCount)
+	{
+		_tasksDone.wait(&_mutex);
+	}
+
+	_task = nullptr;
+	_taskCount = 0;
+}
+
+void WorkerPool::executeTasks()
+{
+	QMutexLocker lock(&_mutex);
+
+	while (!_stopped)
+	{
+		if (_task != nullptr && _nextTask < _taskCount)
+		{
+			const int idx = _nextTask++;
+			const std::function<void(int)>* task = _task;
+			lock.unlock();
+			(*task)(idx);
+			lock.relock();
+			if (++_finishedTasks == _taskCount)
+			{
+				_tasksDone.wakeAll();
+			}
+		}
+		else
+		{
+			_tasksAvailable.wait(&_mutex);
+		}
+	}
+}
@@ -125,7 +125,18 @@ int TC_UNKNOWN_BORDER()
 	BlackBorderDetector detector(3);
 
 	{
+		// the picture is less than a third of the image on all sides
 		Image<ColorRgb> image = createImage(64, 64, 30, 30);
+		for (unsigned x=0; x<image.width(); ++x)
+		{
+			for (unsigned y=0; y<image.height(); ++y)
+			{
+				if (x >= 34 || y >= 34)
+				{
+					image(x,y) = ColorRgb::BLACK;
+				}
+			}
+		}
 		BlackBorder border = detector.process(image);
 		if (border.unknown != true)
 		{
@@ -137,6 +148,162 @@ int TC_UNKNOWN_BORDER()
 	return result;
 }
 
+Image<ColorRgb> createLetterboxImage(unsigned width, unsigned height, unsigned horizontalBorder, unsigned verticalBorder)
+{
+	Image<ColorRgb> image(width, height);
+	for (unsigned x=0; x<image.width(); ++x)
+	{
+		for (unsigned y=0; y<image.height(); ++y)
+		{
+			if (y < horizontalBorder || y >= height - horizontalBorder || x < verticalBorder || x >= width - verticalBorder)
+			{
+				image(x,y) = ColorRgb::BLACK;
+			}
+			else
+			{
+				image(x,y) = ColorRgb(100, 50, 25);
+			}
+		}
+	}
+	return image;
+}
+
+int TC_DETECTION_MODES()
+{
+	int result = 0;
+
+	BlackBorderDetector detector(0.1);
+
+	{
+		Image<ColorRgb> image = createLetterboxImage(160, 90, 10, 20);
+
+		// an overlay (e.g. osd or subtitle) in the centre of the bottom border
+		for (unsigned x=70; x<90; ++x)
+		{
+			for (unsigned y=82; y<87; ++y)
+			{
+				image(x,y) = ColorRgb::WHITE;
+			}
+		}
+
+		const BlackBorder defaultBorder = detector.process(image);
+		const BlackBorder classicBorder = detector.process_classic(image);
+		const BlackBorder osdBorder = detector.process_osd(image);
+		const BlackBorder letterboxBorder = detector.process_letterbox(image);
+
+		if (defaultBorder.unknown || defaultBorder.horizontalSize != 3 || defaultBorder.verticalSize != 20)
+		{
+			std::cerr << "Failed to correctly detect border in default mode" << std::endl;
+			result = -1;
+		}
+		else if (classicBorder.unknown || classicBorder.horizontalSize != 10 || classicBorder.verticalSize != 20)
+		{
+			std::cerr << "Failed to correctly detect border in classic mode" << std::endl;
+			result = -1;
+		}
+		else if (osdBorder.unknown || osdBorder.horizontalSize != 10 || osdBorder.verticalSize != 20)
+		{
+			std::cerr << "Failed to correctly detect border ignoring the overlay in osd mode" << std::endl;
+			result = -1;
+		}
+		else if (letterboxBorder.unknown || letterboxBorder.horizontalSize != 10 || letterboxBorder.verticalSize != 0)
+		{
+			std::cerr << "Failed to correctly detect border ignoring the overlay in letterbox mode" << std::endl;
+			result = -1;
+		}
+		else std::cout << "Correctly detected border in all detection modes" << std::endl;
+	}
+	return result;
+}
+
+int TC_LINE_SUMMARIES()
+{
+	int result = 0;
+
+	{
+		// width not a multiple of the SIMD width
+		Image<ColorRgb> image = createImage(197, 61, 0, 0);
+
+		BlackBorderLineSummaries summaries;
+		BlackBorderLineSummaries referenceSummaries;
+		summaries.scan(image);
+		referenceSummaries.scan<ColorRgb>(image);
+
+		for (int y=0; y<int(image.height()); ++y)
+		{
+			for (int segment=0; segment<BlackBorderLineSummaries::ROW_SEGMENTS; ++segment)
+			{
+				if (summaries.rowMax(y, segment, segment+1) != referenceSummaries.rowMax(y, segment, segment+1))
+				{
+					result = -1;
+				}
+			}
+		}
+		for (int x=0; x<int(image.width()); ++x)
+		{
+			for (int segment=0; segment<BlackBorderLineSummaries::COLUMN_SEGMENTS; ++segment)
+			{
+				if (summaries.columnMax(x, segment, segment+1) != referenceSummaries.columnMax(x, segment, segment+1))
+				{
+					result = -1;
+				}
+			}
+		}
+
+		if (result != 0)
+		{
+			std::cerr << "Failed to reduce rows and columns like the pixel by pixel reduction" << std::endl;
+		}
+		else std::cout << "Correctly reduced rows and columns" << std::endl;
+	}
+	return result;
+}
+
+int TC_PROXY_BORDER()
+{
+	int result = 0;
+
+	BlackBorderDetector detector(0.1);
+
+	{
+		// 2.39:1 movie with pillarbox in a 4K image
+		Image<ColorRgb> image = createLetterboxImage(3840, 2160, 276, 100);
+
+		BlackBorderProxy proxy;
+		proxy.create(image);
+		const BlackBorder border = proxy.toImageBorder(detector.process(proxy.image()));
+
+		// the border is rounded down to a whole proxy block
+		if (border.unknown
+			|| border.horizontalSize > 276 || border.horizontalSize <= 276 - 2160 / BlackBorderProxy::HEIGHT
+			|| border.verticalSize > 100 || border.verticalSize <= 100 - 3840 / BlackBorderProxy::WIDTH)
+		{
+			std::cerr << "Failed to correctly detect border on the proxy image" << std::endl;
+			result = -1;
+		}
+		else std::cout << "Correctly detected border on the proxy image" << std::endl;
+	}
+
+	{
+		// the picture starts late in a proxy block (rows 240..299, columns 60..119), behind the pixels sampled in the middle of the block
+		Image<ColorRgb> image = createLetterboxImage(3840, 2160, 295, 115);
+
+		BlackBorderProxy proxy;
+		proxy.create(image);
+		const BlackBorder border = proxy.toImageBorder(detector.process(proxy.image()));
+
+		if (border.unknown
+			|| border.horizontalSize > 295 || border.horizontalSize <= 295 - 2160 / BlackBorderProxy::HEIGHT
+			|| border.verticalSize > 115 || border.verticalSize <= 115 - 3840 / BlackBorderProxy::WIDTH)
+		{
+			std::cerr << "Failed to keep the picture starting late in a block of the proxy image" << std::endl;
+			result = -1;
+		}
+		else std::cout << "Correctly kept the picture starting late in a block of the proxy image" << std::endl;
+	}
+	return result;
+}
+
 int main()
 {
 	TC_NO_BORDER();
@@ -144,6 +311,9 @@ int main()
 	TC_LEFT_BORDER();
 	TC_DUAL_BORDER();
 	TC_UNKNOWN_BORDER();
+	TC_DETECTION_MODES();
+	TC_LINE_SUMMARIES();
+	TC_PROXY_BORDER();
 
 	return 0;
 }
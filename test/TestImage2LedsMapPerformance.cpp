@@ -0,0 +1,225 @@
+// STL includes
+#include <iostream>
+#include <vector>
+
+// QT includes
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSharedPointer>
+#include <QThread>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+#include <utils/Logger.h>
+#include <utils/WorkerPool.h>
+
+// Hyperion includes
+#include <hyperion/ImageToLedsMap.h>
+
+///
+/// Creates a classic LED layout around the border of the image
+///
+/// @param ledCount The number of LEDs (split 1/3 top, 1/3 bottom, 1/6 left, 1/6 right)
+/// @param depth The depth of each LED area relative to the image size
+///
+static std::vector<Led> createClassicLayout(int ledCount, double depth)
+{
+	std::vector<Led> leds;
+
+	const int horizontalCount = ledCount / 3;
+	const int verticalCount = (ledCount - 2 * horizontalCount) / 2;
+
+	for (int i = 0; i < horizontalCount; ++i)
+	{
+		const double minX = double(i) / horizontalCount;
+		const double maxX = double(i + 1) / horizontalCount;
+		leds.push_back({minX, maxX, 0.0, depth, ColorOrder::ORDER_RGB});
+		leds.push_back({minX, maxX, 1.0 - depth, 1.0, ColorOrder::ORDER_RGB});
+	}
+
+	for (int i = 0; i < verticalCount; ++i)
+	{
+		const double minY = double(i) / verticalCount;
+		const double maxY = double(i + 1) / verticalCount;
+		leds.push_back({0.0, depth, minY, maxY, ColorOrder::ORDER_RGB});
+		leds.push_back({1.0 - depth, 1.0, minY, maxY, ColorOrder::ORDER_RGB});
+	}
+
+	return leds;
+}
+
+///
+/// Creates a matrix LED layout covering the whole image, where each LED area overlaps its neighbours
+///
+/// @param columns The number of LED columns
+/// @param rows The number of LED rows
+///
+static std::vector<Led> createMatrixLayout(int columns, int rows)
+{
+	std::vector<Led> leds;
+
+	for (int row = 0; row < rows; ++row)
+	{
+		for (int column = 0; column < columns; ++column)
+		{
+			const double minX = qMax(double(column - 1) / columns, 0.0);
+			const double maxX = qMin(double(column + 2) / columns, 1.0);
+			const double minY = qMax(double(row - 1) / rows, 0.0);
+			const double maxY = qMin(double(row + 2) / rows, 1.0);
+			leds.push_back({minX, maxX, minY, maxY, ColorOrder::ORDER_RGB});
+		}
+	}
+
+	return leds;
+}
+
+///
+/// Reference implementation using one index list per LED and a color map for dominant colors,
+/// as the mapping was implemented before the LED areas were stored in a single contiguous table
+///
+class IndexListMap
+{
+public:
+	IndexListMap(int width, int height, const std::vector<Led> & leds)
+	{
+		for (const Led& led : leds)
+		{
+			const int minX = qMin(qRound(width * led.minX_frac), width - 1);
+			const int maxX = qMax(qMin(qRound(width * led.maxX_frac), width), minX + 1);
+			const int minY = qMin(qRound(height * led.minY_frac), height - 1);
+			const int maxY = qMax(qMin(qRound(height * led.maxY_frac), height), minY + 1);
+
+			std::vector<int> ledIndices;
+			for (int y = minY; y < maxY; ++y)
+			{
+				for (int x = minX; x < maxX; ++x)
+				{
+					ledIndices.push_back(y * width + x);
+				}
+			}
+			_colorsMap.push_back(ledIndices);
+		}
+	}
+
+	void getMeanLedColor(const Image<ColorRgb> & image, std::vector<ColorRgb> & ledColors) const
+	{
+		auto led = ledColors.begin();
+		for (const std::vector<int> & pixels : _colorsMap)
+		{
+			uint_fast32_t cummRed = 0, cummGreen = 0, cummBlue = 0;
+			for (const int pixelOffset : pixels)
+			{
+				const ColorRgb & pixel = image.memptr()[pixelOffset];
+				cummRed   += pixel.red;
+				cummGreen += pixel.green;
+				cummBlue  += pixel.blue;
+			}
+			const auto pixelNum = pixels.size();
+			*led++ = ColorRgb(uint8_t(cummRed/pixelNum), uint8_t(cummGreen/pixelNum), uint8_t(cummBlue/pixelNum));
+		}
+	}
+
+	void getDominantLedColor(const Image<ColorRgb> & image, std::vector<ColorRgb> & ledColors) const
+	{
+		auto led = ledColors.begin();
+		for (const std::vector<int> & pixels : _colorsMap)
+		{
+			ColorRgb dominantColor {ColorRgb::BLACK};
+			QMap<QRgb,int> colorDistributionMap;
+			int count = 0;
+			for (const int pixelOffset : pixels)
+			{
+				const QRgb color = image.memptr()[pixelOffset].rgb();
+				const int colorsFound = ++colorDistributionMap[color];
+				if (colorsFound > count)
+				{
+					dominantColor.setRgb(color);
+					count = colorsFound;
+				}
+			}
+			*led++ = dominantColor;
+		}
+	}
+
+private:
+	std::vector<std::vector<int>> _colorsMap;
+};
+
+///
+/// Runs the given mapping function for a number of frames and prints the time per frame
+///
+template <typename Func_T>
+static void benchmark(const char* name, int frames, Func_T func)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		func();
+	}
+
+	const double usPerFrame = static_cast<double>(timer.nsecsElapsed()) / 1000.0 / frames;
+	std::cout << "  " << name << ": " << usPerFrame << " us/frame" << std::endl;
+}
+
+int main()
+{
+	Logger* log = Logger::getInstance("TestImage2LedsMapPerformance");
+	Logger::setLogLevel(Logger::WARNING);
+
+	const int frames = 2000;
+
+	const std::vector<std::pair<const char*, std::vector<Led>>> layouts {
+		{"classic", createClassicLayout(600, 0.08)},
+		{"matrix", createMatrixLayout(32, 18)}
+	};
+
+	const std::vector<std::pair<int,int>> sizes { {160, 90}, {480, 270}, {960, 540} };
+
+	for (const auto & layout : layouts)
+	{
+		const std::vector<Led> & leds = layout.second;
+
+		for (const auto & size : sizes)
+		{
+			const int width = size.first;
+			const int height = size.second;
+
+			// Fill the image with a deterministic pattern
+			Image<ColorRgb> image(width, height);
+			for (int idx = 0; idx < width * height; ++idx)
+			{
+				image.memptr()[idx] = ColorRgb(uint8_t(idx), uint8_t(idx >> 3), uint8_t(idx * 7));
+			}
+
+			std::cout << "Layout " << layout.first << ", image " << width << "x" << height << ", " << leds.size() << " LEDs" << std::endl;
+
+			std::vector<ColorRgb> ledColors(leds.size());
+
+			IndexListMap indexListMap(width, height, leds);
+			benchmark("multicolor_mean (index lists)", frames, [&]() { indexListMap.getMeanLedColor(image, ledColors); });
+
+			hyperion::ImageToLedsMap map(log, width, height, 0, 0, leds, 0, 0);
+			benchmark("multicolor_mean", frames, [&]() { map.getMeanLedColor(image, ledColors); });
+			benchmark("multicolor_mean_squared", frames, [&]() { map.getMeanLedColorSqrt(image, ledColors); });
+			benchmark("multicolor_mean_integral", frames, [&]() { map.getMeanLedColorIntegral(image, ledColors); });
+			benchmark("dominant_color (color map)", frames / 200, [&]() { indexListMap.getDominantLedColor(image, ledColors); });
+			benchmark("dominant_color", frames, [&]() { map.getDominantLedColor(image, ledColors); });
+			map.setDominantColorRefinement(false);
+			benchmark("dominant_color (no refinement)", frames, [&]() { map.getDominantLedColor(image, ledColors); });
+			benchmark("dominant_color_advanced", frames / 20, [&]() { map.getDominantLedColorAdv(image, ledColors); });
+			std::cout << "    average k-means iterations per LED: " << map.getKMeansStatistics().averageIterations() << std::endl;
+
+			const int threads = qMax(QThread::idealThreadCount(), 2);
+			map.setWorkerPool(QSharedPointer<WorkerPool>(new WorkerPool(threads)));
+			std::cout << "  using " << threads << " threads" << std::endl;
+			benchmark("multicolor_mean", frames, [&]() { map.getMeanLedColor(image, ledColors); });
+			benchmark("dominant_color", frames, [&]() { map.getDominantLedColor(image, ledColors); });
+			benchmark("dominant_color_advanced", frames / 20, [&]() { map.getDominantLedColorAdv(image, ledColors); });
+		}
+	}
+
+	return 0;
+}
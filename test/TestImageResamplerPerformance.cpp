@@ -0,0 +1,165 @@
+// STL includes
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// QT includes
+#include <QElapsedTimer>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/ColorSys.h>
+#include <utils/Image.h>
+#include <utils/ImageResampler.h>
+#include <utils/Logger.h>
+
+///
+/// Reference implementation converting one pixel at a time and selecting the pixel format per pixel,
+/// as the resampler was implemented before the conversion was done by row kernels
+///
+static void referenceProcessImage(const uint8_t* data, int width, int height, int lineLength, int decimation, PixelFormat pixelFormat, Image<ColorRgb>& outputImage)
+{
+	const int outputWidth = (width - (decimation >> 1) + decimation - 1) / decimation;
+	const int outputHeight = (height - (decimation >> 1) + decimation - 1) / decimation;
+	outputImage.resize(outputWidth, outputHeight);
+
+	for (int yDest = 0, ySource = decimation >> 1; yDest < outputHeight; ySource += decimation, ++yDest)
+	{
+		const int yOffset = lineLength * ySource;
+		const int uOffset = (pixelFormat == PixelFormat::NV12) ? (height + ySource / 2) * lineLength : width * height + (ySource / 2) * width / 2;
+		const int vOffset = width * height + (width * height) / 4 + (ySource / 2) * width / 2;
+
+		for (int xDest = 0, xSource = decimation >> 1; xDest < outputWidth; xSource += decimation, ++xDest)
+		{
+			ColorRgb& rgb = outputImage(xDest, yDest);
+			switch (pixelFormat)
+			{
+			case PixelFormat::UYVY:
+			{
+				const int index = yOffset + (xSource << 1);
+				const uint8_t u = ((xSource & 1) == 0) ? data[index] : data[index - 2];
+				const uint8_t v = ((xSource & 1) == 0) ? data[index + 2] : data[index];
+				ColorSys::yuv2rgb(data[index + 1], u, v, rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			case PixelFormat::YUYV:
+			{
+				const int index = yOffset + (xSource << 1);
+				const uint8_t u = ((xSource & 1) == 0) ? data[index + 1] : data[index - 1];
+				const uint8_t v = ((xSource & 1) == 0) ? data[index + 3] : data[index + 1];
+				ColorSys::yuv2rgb(data[index], u, v, rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			case PixelFormat::BGR16:
+			{
+				const int index = yOffset + (xSource << 1);
+				rgb.blue  = (data[index] & 0x1f) << 3;
+				rgb.green = (((data[index + 1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2;
+				rgb.red   = (data[index + 1] & 0xF8);
+				break;
+			}
+			case PixelFormat::BGR24:
+			{
+				const int index = yOffset + (xSource << 1) + xSource;
+				rgb = ColorRgb(data[index + 2], data[index + 1], data[index]);
+				break;
+			}
+			case PixelFormat::RGB32:
+			{
+				const int index = yOffset + (xSource << 2);
+				rgb = ColorRgb(data[index], data[index + 1], data[index + 2]);
+				break;
+			}
+			case PixelFormat::BGR32:
+			{
+				const int index = yOffset + (xSource << 2);
+				rgb = ColorRgb(data[index + 2], data[index + 1], data[index]);
+				break;
+			}
+			case PixelFormat::NV12:
+				ColorSys::yuv2rgb(data[yOffset + xSource], data[uOffset + ((xSource >> 1) << 1)], data[uOffset + ((xSource >> 1) << 1) + 1], rgb.red, rgb.green, rgb.blue);
+				break;
+			case PixelFormat::I420:
+				ColorSys::yuv2rgb(data[yOffset + xSource], data[uOffset + (xSource >> 1)], data[vOffset + (xSource >> 1)], rgb.red, rgb.green, rgb.blue);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+///
+/// Runs the given conversion function for a number of frames and prints the time per frame
+///
+template <typename Func_T>
+static void benchmark(const char* name, int frames, Func_T func)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		func();
+	}
+
+	const double msPerFrame = static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / frames;
+	std::cout << "  " << name << ": " << msPerFrame << " ms/frame" << std::endl;
+}
+
+int main()
+{
+	Logger::setLogLevel(Logger::WARNING);
+
+	const int frames = 20;
+	const int width = 3840;
+	const int height = 2160;
+
+	const std::vector<std::pair<PixelFormat, int>> formats {
+		{PixelFormat::YUYV, 2}, {PixelFormat::UYVY, 2}, {PixelFormat::NV12, 1}, {PixelFormat::I420, 1},
+		{PixelFormat::BGR16, 2}, {PixelFormat::BGR24, 3}, {PixelFormat::RGB32, 4}, {PixelFormat::BGR32, 4}
+	};
+
+	// Large enough for all formats, filled with a deterministic pattern
+	std::vector<uint8_t> data(static_cast<size_t>(width) * height * 4);
+	for (size_t idx = 0; idx < data.size(); ++idx)
+	{
+		data[idx] = static_cast<uint8_t>(idx * 7 + (idx >> 11));
+	}
+
+	for (const auto & format : formats)
+	{
+		const PixelFormat pixelFormat = format.first;
+		const int lineLength = width * format.second;
+
+		for (int decimation : {1, 2, 8, 16})
+		{
+			std::cout << "Format " << pixelFormatToString(pixelFormat).toStdString() << ", image " << width << "x" << height << ", decimation " << decimation << std::endl;
+
+			ImageResampler resampler;
+			resampler.setHorizontalPixelDecimation(decimation);
+			resampler.setVerticalPixelDecimation(decimation);
+
+			Image<ColorRgb> reference;
+			Image<ColorRgb> image;
+			benchmark("per pixel (reference)", frames, [&]() { referenceProcessImage(data.data(), width, height, lineLength, decimation, pixelFormat, reference); });
+			benchmark("row kernels", frames, [&]() { resampler.processImage(data.data(), width, height, lineLength, pixelFormat, image); });
+
+			const Image<ColorRgb>& constReference = reference;
+			const Image<ColorRgb>& constImage = image;
+			if (image.width() != reference.width() || image.height() != reference.height() ||
+				memcmp(constImage.memptr(), constReference.memptr(), static_cast<size_t>(image.size())) != 0)
+			{
+				std::cout << "  ERROR: row kernels differ from the reference" << std::endl;
+			}
+
+			if (decimation > 1)
+			{
+				resampler.setPixelDecimationAveraging(true);
+				benchmark("area averaging", frames, [&]() { resampler.processImage(data.data(), width, height, lineLength, pixelFormat, image); });
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+// STL includes
+#include <iostream>
+
+// QT includes
+#include <QCoreApplication>
+#include <QStringList>
+
+// Utils includes
+#include <utils/LatestValueSlotTable.h>
+
+using Table = LatestValueSlotTable<int>;
+
+///
+/// Receiver recording the calls in the order they are processed, like the instance for its producers
+///
+class Receiver : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit Receiver(Table& table)
+		: _table(table)
+	{
+	}
+
+	QStringList events;
+
+public slots:
+	void deliver(int index)
+	{
+		int value;
+		if (_table.take(index, value))
+		{
+			events << QString("value %1").arg(value);
+		}
+	}
+
+	void runPostedClear(int index, quint32 sequence)
+	{
+		_table.runClear(sequence, [&]() {
+			clear(index);
+		});
+	}
+
+	void clear(int index)
+	{
+		_table.discard(index);
+		events << "clear";
+	}
+
+	void registerInput(int /*index*/)
+	{
+		events << "register";
+	}
+
+private:
+	Table& _table;
+};
+
+static void postClear(Table& table, int index)
+{
+	table.requestClear([&](QObject* receiver, quint32 sequence) {
+		QMetaObject::invokeMethod(receiver, "runPostedClear", Qt::QueuedConnection, Q_ARG(int, index), Q_ARG(quint32, sequence));
+	});
+}
+
+static bool expect(const QString& name, Receiver& receiver, const QStringList& expected)
+{
+	// wake-ups queued while processing the events are processed by the next call
+	for (int pass = 0; pass < 3; ++pass)
+	{
+		QCoreApplication::processEvents();
+	}
+
+	const bool passed = receiver.events == expected;
+	std::cout << (passed ? "PASS " : "FAIL ") << name.toStdString() << ": " << receiver.events.join(", ").toStdString() << std::endl;
+	receiver.events.clear();
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	QCoreApplication app(argc, argv);
+
+	Table table(1);
+	Receiver receiver(table);
+	table.open(&receiver, "deliver");
+	table.create(0);
+
+	bool passed = true;
+
+	// A value published after a clear and register is set after them, even if the wake-up of an earlier value is
+	// queued ahead of the clear
+	table.publish(0, 1);
+	postClear(table, 0);
+	QMetaObject::invokeMethod(&receiver, "registerInput", Qt::QueuedConnection, Q_ARG(int, 0));
+	table.publish(0, 2);
+	passed &= expect("clear, register and value in order", receiver, { "clear", "register", "value 2" });
+
+	// A value published before a clear is set before it
+	table.publish(0, 3);
+	postClear(table, 0);
+	passed &= expect("value before clear", receiver, { "value 3", "clear" });
+
+	// A clear of the receiver drops the values published before
+	table.publish(0, 4);
+	receiver.clear(0);
+	passed &= expect("clear drops value", receiver, { "clear" });
+
+	// Values published after several clears are set after the last one
+	table.publish(0, 5);
+	postClear(table, 0);
+	table.publish(0, 6);
+	postClear(table, 0);
+	table.publish(0, 7);
+	passed &= expect("value after last clear", receiver, { "clear", "clear", "value 7" });
+
+	// A closed table drops the values published
+	table.close();
+	table.publish(0, 8);
+	passed &= expect("closed table", receiver, {});
+
+	return passed ? 0 : 1;
+}
+
+#include "TestLatestValueSlotTable.moc"
@@ -0,0 +1,103 @@
+// STL includes
+#include <iostream>
+#include <vector>
+
+// QT includes
+#include <QElapsedTimer>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/FrameDecoderStatistics.h>
+#include <utils/Image.h>
+#include <utils/ImageMetadata.h>
+#include <utils/Logger.h>
+
+// Grabber includes
+#include <grabber/EncoderThread.h>
+
+///
+/// Decodes the given MJPEG frame repeatedly and prints the time per frame and the resulting image size
+///
+static void benchmark(const char* name, EncoderThread& encoder, std::vector<uint8_t>& jpeg, int width, int height, int crop, int decimation, int frames)
+{
+	Image<ColorRgb> result;
+	bool decoded {false};
+	QObject::connect(&encoder, &EncoderThread::frameProcessed, [&](quint64, const Image<ColorRgb>& image, bool success) {
+		result = image;
+		decoded = success;
+	});
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		encoder.setup(PixelFormat::MJPEG, jpeg.data(), static_cast<int>(jpeg.size()), width, height, 0,
+			crop, crop, crop, crop, VideoMode::VIDEO_2D, FlipMode::NO_CHANGE, decimation, false,
+			true, -1, ImageMetadata(), static_cast<quint64>(frame + 1));
+		encoder.process();
+	}
+
+	const double msPerFrame = static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / frames;
+	std::cout << "  " << name << ", decimation " << decimation << ": " << msPerFrame << " ms/frame, image "
+		<< result.width() << "x" << result.height() << (decoded ? "" : " (ERROR: not decoded)") << std::endl;
+
+	QObject::disconnect(&encoder, &EncoderThread::frameProcessed, nullptr, nullptr);
+}
+
+int main()
+{
+	Logger::setLogLevel(Logger::WARNING);
+
+	const int frames = 50;
+	const int width = 1920;
+	const int height = 1080;
+
+	// Compress a deterministic pattern, subsampled like the MJPEG stream of most USB grabbers
+	std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			uint8_t* pixel = &rgb[(static_cast<size_t>(y) * width + x) * 3];
+			pixel[0] = static_cast<uint8_t>(x * 255 / width);
+			pixel[1] = static_cast<uint8_t>(y * 255 / height);
+			pixel[2] = static_cast<uint8_t>((x ^ y) & 0xFF);
+		}
+	}
+
+	tjhandle compressor = tjInitCompress();
+	unsigned char* jpegBuffer = nullptr;
+	unsigned long jpegSize = 0;
+	if (tjCompress2(compressor, rgb.data(), width, 0, height, TJPF_RGB, &jpegBuffer, &jpegSize, TJSAMP_422, 85, 0) < 0)
+	{
+		std::cout << "ERROR: compressing the test frame failed" << std::endl;
+		tjDestroy(compressor);
+		return 1;
+	}
+	std::vector<uint8_t> jpeg(jpegBuffer, jpegBuffer + jpegSize);
+	tjFree(jpegBuffer);
+	tjDestroy(compressor);
+
+	std::cout << "MJPEG image " << width << "x" << height << ", " << jpegSize << " bytes" << std::endl;
+
+	EncoderThread encoder;
+	for (int decimation : {1, 2, 4, 8, 16})
+	{
+		benchmark("full frame", encoder, jpeg, width, height, 0, decimation, frames);
+	}
+	for (int decimation : {1, 2, 4, 8, 16})
+	{
+		benchmark("cropped by 240 pixels", encoder, jpeg, width, height, 240, decimation, frames);
+	}
+
+	const FrameDecoderStatistics::Statistics statistics = FrameDecoderStatistics::getInstance().statistics();
+	std::cout << "Decoding time per scale factor:" << std::endl;
+	for (int scale = 0; scale < FrameDecoderStatistics::MJPEG_SCALES; ++scale)
+	{
+		std::cout << "  1/" << (1 << scale) << ": " << statistics.mjpeg[scale].averageMs() << " ms/frame ("
+			<< statistics.mjpeg[scale].frames << " frames)" << std::endl;
+	}
+
+	return 0;
+}
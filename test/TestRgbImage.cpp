@@ -7,6 +7,7 @@
 #include <utils/ColorRgba.h>
 #include <utils/ColorRgb.h>
 #include <utils/ColorBgr.h>
+#include <utils/FrameBufferPool.h>
 #include <hyperion/ImageProcessor.h>
 
 int main()
@@ -40,6 +41,48 @@ int main()
 	
 	
 
+	std::cout << "Reusing frame buffers" << std::endl;
+	const FrameBufferPool::Statistics before = FrameBufferPool::getInstance().statistics();
+	for (int frame = 0; frame < 100; ++frame)
+	{
+		Image<ColorRgb> frameImage(width, height);
+		if (reinterpret_cast<uintptr_t>(frameImage.memptr()) % FrameBufferPool::ALIGNMENT != 0)
+			std::cout << "Frame buffer not aligned" << std::endl;
+	}
+	const FrameBufferPool::Statistics after = FrameBufferPool::getInstance().statistics();
+
+	// Only the first frame may allocate a new buffer
+	if ((after.acquired - before.acquired) - (after.reused - before.reused) > 1)
+		std::cout << "Frame buffers not reused: " << (after.acquired - before.acquired) << " acquired, " << (after.reused - before.reused) << " reused" << std::endl;
+
+	std::cout << "Handing over frames" << std::endl;
+	const quint64 copiesBefore = FrameBufferPool::getInstance().statistics().copies;
+	{
+		// Like a grabber, reuse one image for all frames while the receiver keeps the previous frame
+		Image<ColorRgb> grabbed;
+		Image<ColorRgb> received;
+		for (int frame = 0; frame < 100; ++frame)
+		{
+			grabbed.reset(width, height);
+			grabbed.memptr()[0] = ColorRgb{static_cast<uint8_t>(frame), 0, 0};
+			grabbed.setMetadata(ImageMetadata(frame + 1, static_cast<quint64>(frame) * 2 + 1, ImageMetadata::sourceIdOf("test")));
+			const ImageMetadata previous = received.metadata();
+			received = grabbed;
+			const Image<ColorRgb>& constReceived = received;
+			const Image<ColorRgb>& constGrabbed = grabbed;
+			if (constReceived.memptr() != constGrabbed.memptr() || constReceived(0, 0).red != frame)
+				std::cout << "Frame not shared with receiver" << std::endl;
+			if (received.captureTime() != frame + 1)
+				std::cout << "Capture time not handed over: " << received.captureTime() << std::endl;
+			// Every other frame is skipped
+			if (frame > 0 && received.metadata().skippedSince(previous) != 1)
+				std::cout << "Skipped frames not detected: " << received.metadata().skippedSince(previous) << std::endl;
+		}
+	}
+	const quint64 copies = FrameBufferPool::getInstance().statistics().copies - copiesBefore;
+	if (copies != 0)
+		std::cout << "Frames deep copied during handover: " << copies << std::endl;
+
 	std::cout << "Finished (destruction will be performed)" << std::endl;
 
 	return 0;
@@ -43,6 +43,7 @@ echo
 echo "Hyperion test execution"
 echo
 exec_test "hyperiond is executable and show version" bin/hyperiond --version
+exec_test "latest value slot table keeps the order of clears and values" bin/test_latestvalueslottable
 
 for cfg in ../config/*json.default
 do